@@ -0,0 +1,856 @@
+/*
+ * Linked List which adapts its synchronization to the observed operation mix
+ *
+ * The list runs in one of three modes :
+ *   exclusive  - one mutex for every operation
+ *   rw         - a read write lock, Member shares it
+ *   optimistic - Member takes no lock : it reads a sequence number, traverses, and
+ *                retries if a writer bumped the sequence number meanwhile (a seqlock).
+ *                Writers take the mutex. Deleted nodes are retired, not freed, so a
+ *                concurrent traversal never touches freed memory.
+ *
+ * A controller thread samples every thread's read/write counts, lock contention and
+ * optimistic retries every ADAPT_INTERVAL microseconds and picks the mode for the
+ * window's write fraction, leaving exclusive mode for rw when the mutex is contended at
+ * a moderate write fraction. Switching is quiescent : the controller raises isSwitching,
+ * waits until no thread is inside an operation, changes the mode (freeing the retired
+ * nodes when leaving optimistic mode) and lowers it again. Every mode change is logged
+ * with the statistics that triggered it to MODE_LOG_FILE.
+ *
+ * With the optional second mix the threads alternate between the two mixes every
+ * phaseOps operations, as when a read mostly workload turns into a batch ingest.
+ *
+ * Compile : gcc -g -Wall -o adaptive_linked_list adaptive_linked_list.c -lm -lpthread
+ * Run : ./adaptive_linked_list noOfSamples n m noOfThreads mMember mInsert mDelete [mMember2 mInsert2 mDelete2 phaseOps]
+ *
+ * */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "memory_stats.h"
+#include "sample_clock.h"
+#include "sample_stats.h"
+
+#define MAX_THREADS 1024
+#define MAX_RANDOM 65535
+
+//Synchronization modes
+#define MODE_EXCLUSIVE 0
+#define MODE_RW 1
+#define MODE_OPTIMISTIC 2
+#define MODES 3
+
+//Write fraction at or above which the list runs exclusive
+#define WRITE_EXCLUSIVE 0.30
+
+//Write fraction at or below which the list runs optimistic
+#define WRITE_OPTIMISTIC 0.05
+
+//Margin by which the write fraction has to cross back before leaving a mode
+#define ADAPT_HYSTERESIS 0.05
+
+//Contended lock acquisitions per operation above which the list leaves exclusive mode for
+//rw, as long as the write fraction is below WRITE_CONTENDED : the readers queue behind each
+//other on the mutex although they could share the read lock. Back in rw mode the contention
+//has to fall below CONTENTION_LIMIT - CONTENTION_HYSTERESIS before exclusive is picked again
+#define CONTENTION_LIMIT 0.20
+#define CONTENTION_HYSTERESIS 0.10
+#define WRITE_CONTENDED 0.50
+
+//Optimistic retries per Member above which optimistic mode is left
+#define RETRY_LIMIT 0.05
+
+//Period (microseconds) of the controller, operations needed to judge a window, and
+//consecutive windows which have to agree before the mode changes
+#define ADAPT_INTERVAL 500
+#define ADAPT_MIN_OPS 200
+#define ADAPT_STABLE_WINDOWS 2
+
+//Failed optimistic attempts after which Member takes the mutex
+#define OPTIMISTIC_ATTEMPTS 8
+
+//Retired nodes above which the controller frees them at a quiescent point
+#define RETIRE_LIMIT 4096
+
+//Log of the mode changes
+#define MODE_LOG_FILE "adaptive_modes.log"
+
+// Number of samples
+int noOfSamples = 0;
+
+// Number of nodes in the linked list
+int n = 0;
+
+// Number of random operations in the linked list
+int m = 0;
+
+// Number of threads to execute
+int noOfThreads = 0;
+
+// Fractions of each operation, for both mixes
+float mInsert = 0.0, mDelete = 0.0, mMember = 0.0;
+float mInsert2 = 0.0, mDelete2 = 0.0, mMember2 = 0.0;
+
+// Operations per thread before switching to the other mix, 0 for a single mix
+int phaseOps = 0;
+
+struct list_node_s** head = NULL;
+
+// Current mode, only changed while no thread is inside an operation
+int mode = MODE_RW;
+
+//Raised by the controller while it waits for quiescence to change the mode
+int isSwitching = 0;
+
+//Set to stop the controller thread
+int stopAdapting = 0;
+
+//Seqlock sequence number, odd while a writer modifies the list in optimistic mode
+unsigned long sequence = 0;
+
+pthread_mutex_t mutex;
+pthread_rwlock_t rwlock;
+
+//Nodes deleted in optimistic mode, freed at the next quiescent point
+struct list_node_s **retired = NULL;
+long retiredCount = 0;
+long retiredCapacity = 0;
+
+//Mode statistics of the run
+long modeChanges = 0;
+long reclaims = 0;
+double modeTime[MODES] = {0.0, 0.0, 0.0};
+double modeSince = 0.0;
+double sampleWallStart = 0.0;
+int sampleNumber = 0;
+FILE *modeLog = NULL;
+
+char *modeNames[MODES] = {"exclusive", "rw", "optimistic"};
+
+//Node definition
+struct list_node_s {
+    int data;
+    struct list_node_s *next;
+};
+
+//Per thread state, written by its thread and read by the controller
+struct thread_state_s {
+    int isActive;
+    unsigned long reads;
+    unsigned long writes;
+    unsigned long contended;
+    unsigned long retries;
+} __attribute__((aligned(64)));
+
+struct thread_state_s threadStates[MAX_THREADS];
+
+int Insert(int value, struct list_node_s **head_pp);
+
+int Delete(int value, struct list_node_s **head_pp);
+
+int Member(int value, struct list_node_s *head_p);
+
+int optimisticMember(int value, struct thread_state_s *state_p);
+
+int adaptiveMember(int value, struct thread_state_s *state_p);
+
+int adaptiveUpdate(int isInsert, int value, struct thread_state_s *state_p);
+
+int enterOperation(struct thread_state_s *state_p);
+
+void exitOperation(struct thread_state_s *state_p);
+
+void countEvent(unsigned long *counter_p);
+
+void lockMutex(struct thread_state_s *state_p);
+
+void lockRead(struct thread_state_s *state_p);
+
+void lockWrite(struct thread_state_s *state_p);
+
+void retireNode(struct list_node_s *node_p);
+
+void freeRetired();
+
+void switchMode(int newMode);
+
+int desiredMode(int current, double writeFraction, double contention, double retryRate);
+
+void *adaptOperation();
+
+double calcTime(clock_t startTime, clock_t endTime);
+
+double wallTime();
+
+void validateInput(int argc, char *argv[]);
+
+void populate(int n, struct list_node_s** head_p);
+
+void destroy(struct list_node_s **head_pp);
+
+void measureMemory(struct list_node_s *head_p);
+
+void runOperations(int count, float member, float insert, float delete, struct thread_state_s *state_p);
+
+void *threadOperation(void *id);
+
+void writeOutput(double mean, double std);
+
+int main(int argc, char *argv[]) {
+
+    //Retrieve and validate inputs
+    validateInput(argc, argv);
+
+	//Time spend for a particular sample
+	double sampleTime = 0;
+
+	//Mean of times of all the samples
+	double mean = 0;
+
+	//Standard deviation of all the samples
+	double std = 0;
+
+	//Time keeping variables
+    clock_t startTime, endTime;
+
+	//Controller thread
+	pthread_t adaptHandler;
+
+	//Wall time at which sampling started, used for the sampling time cap
+	time_t samplingStart = time(NULL);
+
+    //Random seed for random values
+    srand(time(NULL));
+
+	modeLog = fopen(MODE_LOG_FILE, "a");
+	if (modeLog == NULL) {
+		printf("Error occured while opening the file \n");
+		exit(1);
+	}
+	fprintf(modeLog, "# n = %d, m = %d, threads = %d, mix = %.3f/%.3f/%.3f", n, m, noOfThreads, mMember, mInsert, mDelete);
+	if (phaseOps > 0)
+		fprintf(modeLog, " alternating with %.3f/%.3f/%.3f every %d operations", mMember2, mInsert2, mDelete2, phaseOps);
+	fprintf(modeLog, "\n");
+
+	for(sampleNumber = 0; sampleNumber < noOfSamples; sampleNumber++){
+
+		//Defining threads
+		pthread_t* threadHandlers;
+		threadHandlers = malloc(sizeof(pthread_t) * noOfThreads);
+
+		int *threadId;
+		threadId = (int *)malloc(sizeof(int) * noOfThreads);
+
+		head = malloc(sizeof(struct list_node_s));
+		resetPeakRss();
+
+		//Populating linked list with random values
+		populate(n,head);
+
+		// Initializing the locks, every sample starts in rw mode
+		pthread_mutex_init(&mutex, NULL);
+		pthread_rwlock_init(&rwlock, NULL);
+		mode = MODE_RW;
+		sequence = 0;
+
+		int i = 0;
+		for (i = 0; i < noOfThreads; i++) {
+			threadStates[i].isActive = 0;
+			threadStates[i].reads = 0;
+			threadStates[i].writes = 0;
+			threadStates[i].contended = 0;
+			threadStates[i].retries = 0;
+		}
+
+		//Recording time at operations start
+		startTime = clock();
+		sampleClockStart();
+		sampleClockThreads(noOfThreads);
+		sampleWallStart = modeSince = wallTime();
+
+		//Starting the controller
+		stopAdapting = 0;
+		pthread_create(&adaptHandler, NULL, adaptOperation, NULL);
+
+		// Thread Creation
+		for (i = 0; i < noOfThreads; i++) {
+			threadId[i] = i;
+			pthread_create(&threadHandlers[i], NULL, threadOperation, (void *) &threadId[i]);
+		}
+
+		// Thread Join
+		for (i = 0; i < noOfThreads; i++) {
+			pthread_join(threadHandlers[i], NULL);
+		}
+
+		//Recording the time at operation ends
+		endTime = clock();
+		sampleClockStop();
+
+		// Stopping the controller
+		__atomic_store_n(&stopAdapting, 1, __ATOMIC_RELAXED);
+		pthread_join(adaptHandler, NULL);
+		modeTime[mode] += wallTime() - modeSince;
+
+		// Destroying the locks
+		pthread_mutex_destroy(&mutex);
+		pthread_rwlock_destroy(&rwlock);
+
+		//Deallocate the memory of this sample's linked list
+		measureMemory(*head);
+		destroy(head);
+		free(head);
+
+		//Deallocate the memory of this sample's thread handlers
+		free(threadHandlers);
+		free(threadId);
+
+		sampleTime = sampleClockTime(calcTime(startTime, endTime));
+		addSample(sampleTime);
+
+		//Stop as soon as the confidence target is met
+		if (isConfidenceReached())
+			break;
+
+		//Stop if the sampling time cap is exceeded
+		if (difftime(time(NULL), samplingStart) > MAX_SAMPLING_TIME)
+			break;
+	}
+
+	fclose(modeLog);
+
+	//Calculate mean for all the samples
+	mean = runningMean;
+
+	//Calculate Standard deviation for all the samples
+	std = findStd();
+
+	writeOutput(mean, std);
+	writeRecord(phaseOps > 0 ? "adaptive-phased" : "adaptive", noOfThreads, n, m, mMember, mInsert, mDelete, mean, std);
+
+    return 0;
+}
+
+
+// Linked List Membership function
+// Links are read with acquire loads, so that optimistic readers see initialized nodes
+int Member(int value, struct list_node_s *head_p) {
+    struct list_node_s *current_p = head_p;
+
+    while (current_p != NULL && current_p->data < value)
+        current_p = __atomic_load_n(&current_p->next, __ATOMIC_ACQUIRE);
+
+    if (current_p == NULL || current_p->data > value) {
+        return 0;
+    }
+    else {
+        return 1;
+    }
+
+}
+
+// Linked List Insertion function
+// The new node is linked with a release store, after it is initialized
+int Insert(int value, struct list_node_s **head_pp) {
+    struct list_node_s *curr_p = *head_pp;
+    struct list_node_s *pred_p = NULL;
+    struct list_node_s *temp_p = NULL;
+
+    while (curr_p != NULL && curr_p->data < value) {
+        pred_p = curr_p;
+        curr_p = curr_p->next;
+    }
+
+    if (curr_p == NULL || curr_p->data > value) {
+        temp_p = malloc(sizeof(struct list_node_s));
+        temp_p->data = value;
+        temp_p->next = curr_p;
+
+        if (pred_p == NULL)
+            __atomic_store_n(head_pp, temp_p, __ATOMIC_RELEASE);
+        else
+            __atomic_store_n(&pred_p->next, temp_p, __ATOMIC_RELEASE);
+
+        return 1;
+    }
+    else
+        return 0;
+}
+
+// Linked List Deletion function
+// In optimistic mode the node is retired, a reader may still be traversing it
+int Delete(int value, struct list_node_s **head_pp) {
+    struct list_node_s *curr_p = *head_pp;
+    struct list_node_s *pred_p = NULL;
+
+    while (curr_p != NULL && curr_p->data < value) {
+        pred_p = curr_p;
+        curr_p = curr_p->next;
+    }
+
+    if (curr_p != NULL && curr_p->data == value) {
+        if (pred_p == NULL)
+            __atomic_store_n(head_pp, curr_p->next, __ATOMIC_RELEASE);
+        else
+            __atomic_store_n(&pred_p->next, curr_p->next, __ATOMIC_RELEASE);
+
+        if (mode == MODE_OPTIMISTIC)
+            retireNode(curr_p);
+        else
+            free(curr_p);
+
+        return 1;
+
+    }
+    else
+        return 0;
+}
+
+//Count an event of the calling thread, a plain store the controller can read at any time
+void countEvent(unsigned long *counter_p) {
+    __atomic_store_n(counter_p, *counter_p + 1, __ATOMIC_RELAXED);
+}
+
+//Lock acquisitions which count a failed first attempt as contention
+void lockMutex(struct thread_state_s *state_p) {
+    if (pthread_mutex_trylock(&mutex) != 0) {
+        countEvent(&state_p->contended);
+        pthread_mutex_lock(&mutex);
+    }
+}
+
+void lockRead(struct thread_state_s *state_p) {
+    if (pthread_rwlock_tryrdlock(&rwlock) != 0) {
+        countEvent(&state_p->contended);
+        pthread_rwlock_rdlock(&rwlock);
+    }
+}
+
+void lockWrite(struct thread_state_s *state_p) {
+    if (pthread_rwlock_trywrlock(&rwlock) != 0) {
+        countEvent(&state_p->contended);
+        pthread_rwlock_wrlock(&rwlock);
+    }
+}
+
+//Keep a deleted node until the next quiescent point, called with the mutex held
+void retireNode(struct list_node_s *node_p) {
+    if (retiredCount == retiredCapacity) {
+        retiredCapacity = retiredCapacity > 0 ? 2 * retiredCapacity : 256;
+        retired = realloc(retired, sizeof(struct list_node_s *) * retiredCapacity);
+    }
+    retired[retiredCount] = node_p;
+    __atomic_store_n(&retiredCount, retiredCount + 1, __ATOMIC_RELAXED);
+}
+
+//Free the retired nodes, only while no thread is inside an operation
+void freeRetired() {
+    long i;
+
+    for (i = 0; i < retiredCount; i++)
+        free(retired[i]);
+    retiredCount = 0;
+}
+
+//Enter an operation and return the mode to run it in
+//The isActive store and the isSwitching load pair with the controller's store and
+//loads, so either the thread waits for the switch or the controller waits for the thread
+int enterOperation(struct thread_state_s *state_p) {
+    while (1) {
+        while (__atomic_load_n(&isSwitching, __ATOMIC_ACQUIRE))
+            sched_yield();
+
+        __atomic_store_n(&state_p->isActive, 1, __ATOMIC_SEQ_CST);
+        if (!__atomic_load_n(&isSwitching, __ATOMIC_SEQ_CST))
+            return mode;
+        __atomic_store_n(&state_p->isActive, 0, __ATOMIC_RELEASE);
+    }
+}
+
+void exitOperation(struct thread_state_s *state_p) {
+    __atomic_store_n(&state_p->isActive, 0, __ATOMIC_RELEASE);
+}
+
+//Lock free Member validated by the sequence number, falling back to the mutex
+int optimisticMember(int value, struct thread_state_s *state_p) {
+    unsigned long before;
+    int attempt, result;
+
+    for (attempt = 0; attempt < OPTIMISTIC_ATTEMPTS; attempt++) {
+        before = __atomic_load_n(&sequence, __ATOMIC_ACQUIRE);
+        if ((before & 1) == 0) {
+            result = Member(value, __atomic_load_n(head, __ATOMIC_ACQUIRE));
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&sequence, __ATOMIC_RELAXED) == before)
+                return result;
+        }
+        countEvent(&state_p->retries);
+    }
+
+    lockMutex(state_p);
+    result = Member(value, *head);
+    pthread_mutex_unlock(&mutex);
+    return result;
+}
+
+int adaptiveMember(int value, struct thread_state_s *state_p) {
+    int result;
+    int current = enterOperation(state_p);
+
+    countEvent(&state_p->reads);
+    if (current == MODE_EXCLUSIVE) {
+        lockMutex(state_p);
+        result = Member(value, *head);
+        pthread_mutex_unlock(&mutex);
+    } else if (current == MODE_RW) {
+        lockRead(state_p);
+        result = Member(value, *head);
+        pthread_rwlock_unlock(&rwlock);
+    } else {
+        result = optimisticMember(value, state_p);
+    }
+
+    exitOperation(state_p);
+    return result;
+}
+
+int adaptiveUpdate(int isInsert, int value, struct thread_state_s *state_p) {
+    int result;
+    int current = enterOperation(state_p);
+
+    countEvent(&state_p->writes);
+    if (current == MODE_RW) {
+        lockWrite(state_p);
+        result = isInsert ? Insert(value, head) : Delete(value, head);
+        pthread_rwlock_unlock(&rwlock);
+    } else {
+        lockMutex(state_p);
+        if (current == MODE_OPTIMISTIC) {
+            //Odd sequence number while the list changes
+            __atomic_store_n(&sequence, sequence + 1, __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_RELEASE);
+        }
+        result = isInsert ? Insert(value, head) : Delete(value, head);
+        if (current == MODE_OPTIMISTIC)
+            __atomic_store_n(&sequence, sequence + 1, __ATOMIC_RELEASE);
+        pthread_mutex_unlock(&mutex);
+    }
+
+    exitOperation(state_p);
+    return result;
+}
+
+//Change the mode once no thread is inside an operation
+//Switching to the current mode only frees the retired nodes
+void switchMode(int newMode) {
+    int i;
+    double now;
+
+    __atomic_store_n(&isSwitching, 1, __ATOMIC_SEQ_CST);
+    for (i = 0; i < noOfThreads; i++) {
+        while (__atomic_load_n(&threadStates[i].isActive, __ATOMIC_SEQ_CST))
+            sched_yield();
+    }
+
+    if (mode == MODE_OPTIMISTIC)
+        freeRetired();
+    if (newMode != mode) {
+        now = wallTime();
+        modeTime[mode] += now - modeSince;
+        modeSince = now;
+        mode = newMode;
+    }
+
+    __atomic_store_n(&isSwitching, 0, __ATOMIC_RELEASE);
+}
+
+//Mode for a window's write fraction, lock contention and optimistic retry rate
+//Leaving a mode needs the fraction to cross back by ADAPT_HYSTERESIS, so that a mix
+//close to a threshold does not make the list switch back and forth
+int desiredMode(int current, double writeFraction, double contention, double retryRate) {
+    //Readers held up on the mutex at a moderate write fraction, sharing the read lock pays off
+    int contended = writeFraction < WRITE_CONTENDED &&
+            (contention > CONTENTION_LIMIT ||
+             (current == MODE_RW && contention > CONTENTION_LIMIT - CONTENTION_HYSTERESIS));
+
+    if (writeFraction >= WRITE_EXCLUSIVE && !contended)
+        return MODE_EXCLUSIVE;
+    if (current == MODE_EXCLUSIVE && writeFraction >= WRITE_EXCLUSIVE - ADAPT_HYSTERESIS && !contended)
+        return MODE_EXCLUSIVE;
+    if (retryRate > RETRY_LIMIT)
+        return MODE_RW;
+    if (writeFraction <= WRITE_OPTIMISTIC)
+        return MODE_OPTIMISTIC;
+    if (current == MODE_OPTIMISTIC && writeFraction <= WRITE_OPTIMISTIC + ADAPT_HYSTERESIS)
+        return MODE_OPTIMISTIC;
+    return MODE_RW;
+}
+
+//Controller, judges the mix of every window and switches the mode when it changed
+void *adaptOperation() {
+    unsigned long reads, writes, contended, retries;
+    unsigned long lastReads = 0, lastWrites = 0, lastContended = 0, lastRetries = 0;
+    double windowReads, windowWrites, writeFraction, contention, retryRate;
+    int candidate = mode, stableWindows = 0, desired, previous, i;
+
+    while (!__atomic_load_n(&stopAdapting, __ATOMIC_RELAXED)) {
+        usleep(ADAPT_INTERVAL);
+
+        reads = writes = contended = retries = 0;
+        for (i = 0; i < noOfThreads; i++) {
+            reads += __atomic_load_n(&threadStates[i].reads, __ATOMIC_RELAXED);
+            writes += __atomic_load_n(&threadStates[i].writes, __ATOMIC_RELAXED);
+            contended += __atomic_load_n(&threadStates[i].contended, __ATOMIC_RELAXED);
+            retries += __atomic_load_n(&threadStates[i].retries, __ATOMIC_RELAXED);
+        }
+
+        //Too few operations to judge, let the window grow
+        windowReads = reads - lastReads;
+        windowWrites = writes - lastWrites;
+        if (windowReads + windowWrites < ADAPT_MIN_OPS)
+            continue;
+
+        writeFraction = windowWrites / (windowReads + windowWrites);
+        contention = (contended - lastContended) / (windowReads + windowWrites);
+        retryRate = windowReads > 0 ? (retries - lastRetries) / windowReads : 0.0;
+        lastReads = reads;
+        lastWrites = writes;
+        lastContended = contended;
+        lastRetries = retries;
+
+        desired = desiredMode(mode, writeFraction, contention, retryRate);
+        if (desired == mode) {
+            stableWindows = 0;
+        } else {
+            stableWindows = desired == candidate ? stableWindows + 1 : 1;
+            candidate = desired;
+            if (stableWindows >= ADAPT_STABLE_WINDOWS) {
+                previous = mode;
+                switchMode(desired);
+                modeChanges++;
+                stableWindows = 0;
+                fprintf(modeLog, "sample %d, %.3f ms : %s -> %s (write fraction %.3f, contention %.3f, retries per read %.3f)\n",
+                        sampleNumber, 1000 * (wallTime() - sampleWallStart), modeNames[previous], modeNames[desired],
+                        writeFraction, contention, retryRate);
+            }
+        }
+
+        if (mode == MODE_OPTIMISTIC && __atomic_load_n(&retiredCount, __ATOMIC_RELAXED) > RETIRE_LIMIT) {
+            switchMode(mode);
+            reclaims++;
+        }
+    }
+    return NULL;
+}
+
+//Free every node of the list and the retired nodes, leaving it empty
+void destroy(struct list_node_s **head_pp) {
+	struct list_node_s *curr_p = *head_pp;
+	struct list_node_s *next_p;
+
+	while (curr_p != NULL) {
+		next_p = curr_p->next;
+		free(curr_p);
+		curr_p = next_p;
+	}
+	*head_pp = NULL;
+	freeRetired();
+}
+
+//Record the memory footprint of the list at the end of a sample
+void measureMemory(struct list_node_s *head_p) {
+	struct list_node_s *curr_p;
+	long live = 0;
+	double allocated = 0.0;
+	long i;
+
+	for (curr_p = head_p; curr_p != NULL; curr_p = curr_p->next) {
+		live++;
+		allocated += allocatedSize(curr_p);
+	}
+	for (i = 0; i < retiredCount; i++)
+		allocated += allocatedSize(retired[i]);
+	recordMemory(live, (double) live * sizeof(struct list_node_s), allocated,
+			(double) retiredCount * sizeof(struct list_node_s));
+}
+
+//Retrieve and validate the inputs
+void validateInput(int argc, char *argv[]) {
+
+
+    if (argc != 8 && argc != 12) {
+        printf("Enter the command with arguments noOfSamples, n, m, noOfThreads, mMember, mInsert, mDelete and optionally mMember2, mInsert2, mDelete2 and phaseOps\n");
+        exit(0);
+    }
+
+    //Input retrieval
+	noOfSamples = (int) strtol(argv[1], (char**) NULL, 10);
+    n = (int) strtol(argv[2], (char**) NULL, 10);
+    m = (int) strtol(argv[3], (char**) NULL, 10);
+	noOfThreads = (int) strtol(argv[4], (char**) NULL, 10);
+    mMember = (float) atof(argv[5]);
+    mInsert = (float) atof(argv[6]);
+    mDelete = (float) atof(argv[7]);
+    if (argc == 12) {
+        mMember2 = (float) atof(argv[8]);
+        mInsert2 = (float) atof(argv[9]);
+        mDelete2 = (float) atof(argv[10]);
+        phaseOps = (int) strtol(argv[11], (char**) NULL, 10);
+    }
+
+    //Input validation
+	if (noOfSamples <= 0){
+		printf("Invalid input for noOfSamples (noOfSamples > 0)\n");
+		exit(0);
+	} else if (n <= 0 || n >= MAX_RANDOM){
+		printf("Invalid input for n (0 < n < %d)\n", MAX_RANDOM);
+		exit(0);
+	}else if (m <= 0){
+		printf("Invalid input for m (m > 0)\n");
+		exit(0);
+
+	}else if (mMember + mInsert + mDelete != 1.0){
+		printf("Invalid combination of fractions (Total = 1.0)\n");
+		exit(0);
+	}else if (argc == 12 && (mMember2 + mInsert2 + mDelete2 != 1.0 || phaseOps <= 0)){
+		printf("Invalid second mix (Total = 1.0, phaseOps > 0)\n");
+		exit(0);
+	}
+
+    //Input validation
+    if (noOfThreads <= 0 || noOfThreads > MAX_THREADS) {
+        printf("Invalid no. of Threads (0 < noOfThreads < %d)", MAX_THREADS);
+        exit(0);
+    }
+}
+
+//Run count random operations of one mix
+void runOperations(int count, float member, float insert, float delete, struct thread_state_s *state_p) {
+    int noOfPhaseMember = (int) (member * count);
+    int noOfPhaseInsert = (int) (insert * count);
+    int noOfPhaseDelete = count - noOfPhaseMember - noOfPhaseInsert;
+
+    int totalExecuted = 0;
+	int memberExecuted = 0;
+	int insertExecuted = 0;
+	int deleteExecuted = 0;
+
+	if (noOfPhaseDelete < 0)
+		noOfPhaseDelete = 0;
+
+    while (totalExecuted < noOfPhaseMember + noOfPhaseInsert + noOfPhaseDelete) {
+
+        int randomNumber = rand() % MAX_RANDOM;
+        int randomOperation = rand() % 3;
+
+        if (randomOperation == 0 && memberExecuted < noOfPhaseMember) {
+            adaptiveMember(randomNumber, state_p);
+            memberExecuted++;
+        }
+        else if (randomOperation == 1 && insertExecuted < noOfPhaseInsert) {
+            adaptiveUpdate(1, randomNumber, state_p);
+            insertExecuted++;
+        }
+        else if (randomOperation == 2 && deleteExecuted < noOfPhaseDelete) {
+            adaptiveUpdate(0, randomNumber, state_p);
+            deleteExecuted++;
+        }
+        totalExecuted = insertExecuted + memberExecuted + deleteExecuted;
+    }
+}
+
+// Thread Operations
+void *threadOperation(void *threadId) {
+    int id = *(int *)threadId;
+    struct thread_state_s *state_p = &threadStates[id];
+    int phase = 0, count;
+
+    //Number of operations allocated for the thread
+    int remaining = m / noOfThreads + (m % noOfThreads > id ? 1 : 0);
+
+    sampleClockThreadStart();
+
+    if (phaseOps == 0) {
+        runOperations(remaining, mMember, mInsert, mDelete, state_p);
+        return NULL;
+    }
+
+    //Alternate between the two mixes
+    for (phase = 0; remaining > 0; phase++) {
+        count = remaining < phaseOps ? remaining : phaseOps;
+        if (phase % 2 == 0)
+            runOperations(count, mMember, mInsert, mDelete, state_p);
+        else
+            runOperations(count, mMember2, mInsert2, mDelete2, state_p);
+        remaining -= count;
+    }
+    return NULL;
+}
+
+//Wall clock time in seconds
+double wallTime() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//Linked list population function
+void populate(int n, struct list_node_s** head_p){
+
+	int num,i;
+	*head_p = NULL;
+
+	for(i=0; i<n; ){
+		num = rand() % MAX_RANDOM;
+		if(Insert(num, head_p) == 1)
+			i++;
+	}
+}
+
+//Calculating time between operation start and end
+double calcTime(clock_t startTime, clock_t endTime) {
+    return (double) (endTime - startTime) / CLOCKS_PER_SEC;
+}
+
+void writeOutput(double mean, double std) {
+	double totalTime = modeTime[MODE_EXCLUSIVE] + modeTime[MODE_RW] + modeTime[MODE_OPTIMISTIC];
+	int samples = acceptedSamples + rejectedSamples;
+	FILE *f = fopen("results.txt", "a");
+	if (f == NULL)
+	{
+		printf("Error occured while opening the file \n");
+		exit(1);
+	}
+
+	fprintf(f,"\n === Adaptive === \n\n");
+	fprintf(f,"Number of Nodes = %d\n", n);
+	fprintf(f,"Number of Operations = %d\n", m);
+	fprintf(f,"Member Fraction= %.2f\n", mMember);
+	fprintf(f,"Insert Fraction = %.3f\n", mInsert);
+	fprintf(f,"Delete Fraction = %.3f\n", mDelete);
+	if (phaseOps > 0)
+		fprintf(f,"Alternating with %.3f/%.3f/%.3f every %d operations per thread\n", mMember2, mInsert2, mDelete2, phaseOps);
+	fprintf(f,"Number of Threads = %d\n", noOfThreads);
+	fprintf(f,"Max Number of Samples = %d\n", noOfSamples);
+	fprintf(f,"Number of Samples = %d\n", acceptedSamples);
+	fprintf(f,"Rejected Outliers = %d\n", rejectedSamples);
+	fprintf(f,"Min number of samples needed = %f\n", minNoOfSamples);
+	fprintf(f,"Mean = %f\n", mean);
+	fprintf(f,"Standard Deviation = %f\n", std);
+	fprintf(f,"Throughput (ops/sec) = %f\n", mean > 0 ? m / mean : 0.0);
+	fprintf(f,"Confidence Interval (95%%) = +/- %f (%.2f%% of mean)\n", 1.96*std/sqrt(acceptedSamples), mean > 0 ? 100*1.96*std/sqrt(acceptedSamples)/mean : 0.0);
+	fprintf(f,"Mode Changes per Sample = %f (logged to %s)\n", samples > 0 ? (double) modeChanges / samples : 0.0, MODE_LOG_FILE);
+	fprintf(f,"Retired Node Reclaims = %ld\n", reclaims);
+	if (totalTime > 0)
+		fprintf(f,"Time in Mode (%%) exclusive = %.1f, rw = %.1f, optimistic = %.1f\n", 100 * modeTime[MODE_EXCLUSIVE] / totalTime,
+				100 * modeTime[MODE_RW] / totalTime, 100 * modeTime[MODE_OPTIMISTIC] / totalTime);
+	writeMemoryStats(f);
+	fprintf(f,"________________________________________ \n\n");
+
+	fclose(f);
+}
@@ -0,0 +1,375 @@
+/*
+ * Batched Member lookups on the sequential linked list
+ *
+ * A single Member traversal stalls on one cache miss per hop. MemberMany runs up to
+ * batchSize independent traversals on one thread, interleaved as hand-rolled state
+ * machines (asynchronous memory access chaining) : every step prefetches a traversal's
+ * next node and switches to the next traversal, so the misses of the batch overlap.
+ * Each sample looks up the same m random keys with m sequential Member calls and with
+ * MemberMany, and the two are checked to give the same results. The pass which runs
+ * second finds the list in the caches and the TLB warmed by the first, so the two passes
+ * take turns at going first from one sample to the next.
+ *
+ * Compile : gcc -g -Wall -o batch_linked_list batch_linked_list.c -lm
+ * Run : ./batch_linked_list noOfSamples n m batchSize
+ *
+ * */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+
+#include "sample_stats.h"
+
+#define MAX_RANDOM 65535
+
+//Largest number of traversals interleaved by MemberMany
+#define MAX_BATCH 64
+
+struct list_node_s** head;
+
+// Number of samples
+int noOfSamples = 0;
+
+// Number of nodes in the linked list
+int n = 0;
+
+// Keys are drawn from [0, keyRange), widened beyond MAX_RANDOM for large n
+int keyRange = MAX_RANDOM;
+
+// Number of lookups per sample
+int m = 0;
+
+// Number of traversals interleaved by MemberMany
+int batchSize = 0;
+
+//Running statistics of the sequential time of the same samples, the accepted ones
+//(see sample_stats.h) being those of the batched time
+double sequentialMean = 0.0;
+double sequentialM2 = 0.0;
+
+//Node definition
+struct list_node_s {
+    int data;
+    struct list_node_s *next;
+};
+
+//State of one interleaved traversal
+struct lookup_s {
+    struct list_node_s *curr_p;
+    //Index of the key being looked up, -1 once the slot has no keys left
+    int index;
+};
+
+int Member(int value, struct list_node_s *head_p);
+
+void MemberMany(int keys[], int results[], int count, struct list_node_s *head_p);
+
+void validateInput(int argc, char *argv[]);
+
+double calcTime(clock_t startTime, clock_t endTime);
+
+void addSequentialSample(double sampleTime);
+
+int compareNodes(const void *a, const void *b);
+
+void populate(int n, struct list_node_s **head_p);
+
+void destroy(struct list_node_s **head_pp);
+
+void writeOutput(double mean, double std) ;
+
+int main(int argc, char *argv[]) {
+
+
+	//Retrieve and validate inputs
+	validateInput(argc, argv);
+
+	int sampleNumber = 0;
+	int i;
+
+	//Time spend for a particular sample, batched and sequential
+	double sampleTime = 0;
+	double sequentialTime = 0;
+
+	//Mean of times of all the samples
+	double mean = 0;
+
+	//Standard deviation of all the samples
+	double std = 0;
+
+	//Time keeping variables
+    clock_t startTime, endTime;
+
+	//Wall time at which sampling started, used for the sampling time cap
+	time_t samplingStart = time(NULL);
+
+	//Keys of a sample and the results of both lookup methods
+	int *keys = malloc(sizeof(int) * m);
+	int *sequentialResults = malloc(sizeof(int) * m);
+	int *batchedResults = malloc(sizeof(int) * m);
+
+	char variant[32], sequentialVariant[32];
+
+    //Random seed for random values
+	srand(time(NULL));
+
+	for(sampleNumber = 0; sampleNumber < noOfSamples; sampleNumber++){
+
+		head = malloc(sizeof(struct list_node_s));
+
+		//Populating linked list with random values
+		populate(n,head);
+
+		for (i = 0; i < m; i++)
+			keys[i] = rand() % keyRange;
+
+		//Batched lookups first in odd samples, so that neither pass always runs warm
+		if (sampleNumber % 2 == 1) {
+			startTime = clock();
+			MemberMany(keys, batchedResults, m, *head);
+			endTime = clock();
+			sampleTime = calcTime(startTime, endTime);
+		}
+
+		//Sequential lookups
+		startTime = clock();
+		for (i = 0; i < m; i++)
+			sequentialResults[i] = Member(keys[i], *head);
+		endTime = clock();
+		sequentialTime = calcTime(startTime, endTime);
+
+		//Batched lookups of the same keys in even samples
+		if (sampleNumber % 2 == 0) {
+			startTime = clock();
+			MemberMany(keys, batchedResults, m, *head);
+			endTime = clock();
+			sampleTime = calcTime(startTime, endTime);
+		}
+
+		for (i = 0; i < m; i++) {
+			if (sequentialResults[i] != batchedResults[i]) {
+				printf("MemberMany result of key %d differs from Member\n", keys[i]);
+				exit(1);
+			}
+		}
+
+		//Deallocate the memory of this sample's linked list
+		destroy(head);
+		free(head);
+
+		if (addSample(sampleTime))
+			addSequentialSample(sequentialTime);
+
+		//Stop as soon as the confidence target is met
+		if (isConfidenceReached())
+			break;
+
+		//Stop if the sampling time cap is exceeded
+		if (difftime(time(NULL), samplingStart) > MAX_SAMPLING_TIME)
+			break;
+	}
+
+	//Calculate mean for all the samples
+	mean = runningMean;
+
+	//Calculate Standard deviation for all the samples
+	std = findStd();
+
+	writeOutput(mean, std);
+	snprintf(variant, sizeof(variant), "batched-%d", batchSize);
+	writeRecord(variant, 1, n, m, 1.0, 0.0, 0.0, mean, std);
+	//The sequential baseline of this run, keyed by the batch size it was measured against
+	snprintf(sequentialVariant, sizeof(sequentialVariant), "sequential-b%d", batchSize);
+	writeRecord(sequentialVariant, 1, n, m, 1.0, 0.0, 0.0, sequentialMean,
+			acceptedSamples > 0 ? sqrt(sequentialM2/acceptedSamples) : 0.0);
+
+	free(keys);
+	free(sequentialResults);
+	free(batchedResults);
+    return 0;
+}
+
+
+//Linked List Membership function
+int Member(int value, struct list_node_s* head_p) {
+    struct list_node_s* current_p = head_p;
+
+    while (current_p != NULL && current_p->data < value)
+        current_p = current_p->next;
+
+    if (current_p == NULL || current_p->data > value) {
+        return 0;
+    }
+    else
+        return 1;
+}
+
+//Batched Membership function, results[i] is Member(keys[i], head_p)
+//Each step advances one traversal by a node whose cache line was prefetched when the
+//traversal was last visited, then prefetches its next node and moves on to the next
+//traversal. A finished traversal takes the next key and restarts from the head.
+void MemberMany(int keys[], int results[], int count, struct list_node_s *head_p) {
+    struct lookup_s lookups[MAX_BATCH];
+    struct list_node_s *curr_p;
+    int next = 0, active = 0;
+    int slot;
+
+    for (slot = 0; slot < batchSize; slot++) {
+        if (next < count) {
+            lookups[slot].index = next++;
+            lookups[slot].curr_p = head_p;
+            active++;
+        } else {
+            lookups[slot].index = -1;
+        }
+    }
+
+    while (active > 0) {
+        for (slot = 0; slot < batchSize; slot++) {
+            if (lookups[slot].index < 0)
+                continue;
+
+            curr_p = lookups[slot].curr_p;
+            if (curr_p != NULL && curr_p->data < keys[lookups[slot].index]) {
+                lookups[slot].curr_p = curr_p->next;
+                __builtin_prefetch(curr_p->next);
+                continue;
+            }
+
+            //Traversal finished, record it and start the next key
+            results[lookups[slot].index] = curr_p != NULL && curr_p->data == keys[lookups[slot].index];
+            if (next < count) {
+                lookups[slot].index = next++;
+                lookups[slot].curr_p = head_p;
+            } else {
+                lookups[slot].index = -1;
+                active--;
+            }
+        }
+    }
+}
+
+//Comparison of two nodes by their keys, used to link the populated list
+int compareNodes(const void *a, const void *b) {
+  int x = (*(struct list_node_s * const *) a)->data;
+  int y = (*(struct list_node_s * const *) b)->data;
+  return (x > y) - (x < y);
+}
+
+//Linked list population function
+//Nodes are allocated in random key order, so consecutive list nodes are far apart in memory
+void populate(int n, struct list_node_s** head_p)
+{
+  int num,i;
+  char *used = calloc(keyRange, sizeof(char));
+  struct list_node_s **nodes = malloc(sizeof(struct list_node_s *) * n);
+
+  for(i=0; i<n; ){
+    num = rand() % keyRange;
+    if(used[num])
+      continue;
+    used[num] = 1;
+    nodes[i] = malloc(sizeof(struct list_node_s));
+    nodes[i]->data = num;
+    i++;
+  }
+
+  qsort(nodes, n, sizeof(struct list_node_s *), compareNodes);
+  for(i=0; i<n-1; i++)
+    nodes[i]->next = nodes[i+1];
+  nodes[n-1]->next = NULL;
+  *head_p = nodes[0];
+
+  free(nodes);
+  free(used);
+}
+
+//Free every node of the list, leaving it empty
+void destroy(struct list_node_s **head_pp) {
+  struct list_node_s *curr_p = *head_pp;
+  struct list_node_s *next_p;
+
+  while (curr_p != NULL) {
+    next_p = curr_p->next;
+    free(curr_p);
+    curr_p = next_p;
+  }
+  *head_pp = NULL;
+}
+
+//Retrieve and validate the inputs
+void validateInput(int argc, char *argv[]) {
+
+    if (argc != 5) {
+        printf("Enter the command with arguments noOfSamples, n, m and batchSize\n");
+        exit(0);
+    }
+
+    //Input retrieval
+	noOfSamples = (int) strtol(argv[1], (char **) NULL, 10);
+    n = (int) strtol(argv[2], (char **) NULL, 10);
+    m = (int) strtol(argv[3], (char **) NULL, 10);
+    batchSize = (int) strtol(argv[4], (char **) NULL, 10);
+
+    //Input validation
+	if (noOfSamples <= 0){
+		printf("Invalid input for noOfSamples (noOfSamples > 0)\n");
+		exit(0);
+	} else if (n <= 0){
+		printf("Invalid input for n (n > 0)\n");
+		exit(0);
+	}else if (m <= 0){
+		printf("Invalid input for m (m > 0)\n");
+		exit(0);
+	}else if (batchSize <= 0 || batchSize > MAX_BATCH){
+		printf("Invalid input for batchSize (0 < batchSize <= %d)\n", MAX_BATCH);
+		exit(0);
+	}
+
+	//Keep the list at most half full of the key range
+	if (n > MAX_RANDOM / 2)
+		keyRange = 2 * n;
+}
+
+//Calculating time between operation start and end
+double calcTime(clock_t startTime, clock_t endTime) {
+    return (double) (endTime - startTime) / CLOCKS_PER_SEC;
+}
+
+//Add the sequential time of an accepted sample, acceptedSamples already counts it
+void addSequentialSample(double sampleTime){
+  double delta = sampleTime - sequentialMean;
+
+  sequentialMean += delta/acceptedSamples;
+  sequentialM2 += delta*(sampleTime - sequentialMean);
+}
+
+void writeOutput(double mean, double std) {
+	FILE *f = fopen("results.txt", "a");
+	if (f == NULL)
+	{
+		printf("Error occured while opening the file \n");
+		exit(1);
+	}
+
+	fprintf(f,"\n === Batched Member === \n\n");
+	fprintf(f,"Number of Nodes = %d\n", n);
+	fprintf(f,"Number of Lookups = %d\n", m);
+	fprintf(f,"Batch Size = %d\n", batchSize);
+	fprintf(f,"Max Number of Samples = %d\n", noOfSamples);
+	fprintf(f,"Number of Samples = %d\n", acceptedSamples);
+	fprintf(f,"Rejected Outliers = %d\n", rejectedSamples);
+	fprintf(f,"Min number of samples needed = %f\n", minNoOfSamples);
+	fprintf(f,"Mean = %f\n", mean);
+	fprintf(f,"Standard Deviation = %f\n", std);
+	fprintf(f,"Throughput (ops/sec) = %f\n", mean > 0 ? m / mean : 0.0);
+	fprintf(f,"Confidence Interval (95%%) = +/- %f (%.2f%% of mean)\n", 1.96*std/sqrt(acceptedSamples), mean > 0 ? 100*1.96*std/sqrt(acceptedSamples)/mean : 0.0);
+	fprintf(f,"Sequential Mean = %f\n", sequentialMean);
+	fprintf(f,"Sequential Throughput (ops/sec) = %f\n", sequentialMean > 0 ? m / sequentialMean : 0.0);
+	fprintf(f,"Speedup over Sequential = %f\n", mean > 0 ? sequentialMean / mean : 0.0);
+	fprintf(f,"________________________________________ \n\n");
+
+	fclose(f);
+}
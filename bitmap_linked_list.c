@@ -0,0 +1,697 @@
+/*
+ * Set of a small bounded key universe kept in an atomic bitmap
+ *
+ * With the keys drawn from [0, keyRange) and keyRange small, the whole set fits in
+ * keyRange bits (8 KB for MAX_RANDOM), so Member is one load and Insert and Delete are
+ * one atomic fetch_or / fetch_and on the word of the key : no traversal and no lock.
+ * It is an upper bound to compare the list variants against.
+ *
+ * Above the leaf words sit summary levels, a bit of level l + 1 for every word of level
+ * l, set while that word may be non zero. A word becoming non zero sets its summary bit
+ * (and the levels above it), a word becoming zero clears it and sets it again if the word
+ * was refilled meanwhile, so once the threads are done every non zero word has its
+ * summary bit set (a set summary bit over an empty word is possible and skipped).
+ * Ordered iteration (bitmapNext) skips empty words 64 at a time through the summaries
+ * and range counts popcount the leaf words under the set summary bits.
+ *
+ * The backend is picked from the key range : up to BITMAP_MAX_KEYS keys the bitmap, above
+ * it the sorted list with a read write lock, so that an unbounded universe still runs.
+ *
+ * Compile : gcc -g -Wall -o bitmap_linked_list bitmap_linked_list.c -lm -pthread
+ * Run : ./bitmap_linked_list noOfSamples n m noOfThreads mMember mInsert mDelete [keyRange]
+ *
+ * */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "memory_stats.h"
+#include "sample_clock.h"
+#include "sample_stats.h"
+
+#define MAX_THREADS 1024
+#define MAX_RANDOM 65535
+
+//Backends, picked from the key range
+#define BACKEND_BITMAP 0
+#define BACKEND_LIST 1
+
+//Largest key range kept in a bitmap (2 MB of leaf words) and its number of levels
+#define BITMAP_MAX_KEYS (1 << 24)
+#define BITMAP_LEVELS 4
+
+//Range counts timed after every sample, and the keys each of them covers
+#define RANGE_QUERIES 1000
+#define RANGE_WIDTH 1024
+
+// Number of samples
+int noOfSamples = 0;
+
+// Number of nodes in the linked list
+int n = 0;
+
+// Number of random operations in the linked list
+int m = 0;
+
+// Number of threads to execute
+int noOfThreads = 0;
+
+// Fractions of each operation
+float mInsert = 0.0, mDelete = 0.0, mMember = 0.0;
+
+// Total number of each operation
+int noOfInsert = 0, noOfDelete = 0, noOfMember = 0;
+
+// Values are drawn from [0, keyRange)
+int keyRange = MAX_RANDOM;
+
+// Backend of the set
+int backend = BACKEND_BITMAP;
+
+//Words of every level of the bitmap, level 0 holds the keys
+unsigned long *levels[BITMAP_LEVELS];
+long levelWords[BITMAP_LEVELS];
+int levelCount = 0;
+
+//Node definition of the list backend
+struct list_node_s {
+    int data;
+    struct list_node_s *next;
+};
+
+struct list_node_s *head = NULL;
+pthread_rwlock_t rwlock;
+
+//Statistics of the run
+double iterationTime = 0.0;
+double rangeTime = 0.0;
+long iteratedKeys = 0;
+long iterationMismatches = 0;
+
+int Member(int value);
+
+int Insert(int value);
+
+int Delete(int value);
+
+int bitmapSet(int level, long index);
+
+int bitmapClear(int level, long index);
+
+long bitmapNext(long key);
+
+long bitmapRangeCount(long lo, long hi);
+
+int listMember(int value);
+
+int listInsert(int value);
+
+int listDelete(int value);
+
+long listRangeCount(long lo, long hi);
+
+long orderedCount();
+
+long rangeCount(long lo, long hi);
+
+void create();
+
+void destroy();
+
+void measureMemory();
+
+double calcTime(clock_t startTime, clock_t endTime);
+
+double wallTime();
+
+void validateInput(int argc, char *argv[]);
+
+void populate(int n);
+
+void timeQueries();
+
+void *threadOperation(void *id);
+
+void writeOutput(double mean, double std);
+
+int main(int argc, char *argv[]) {
+
+    //Retrieve and validate inputs
+    validateInput(argc, argv);
+
+	int sampleNumber = 0;
+
+	//Time spend for a particular sample
+	double sampleTime = 0;
+
+	//Mean of times of all the samples
+	double mean = 0;
+
+	//Standard deviation of all the samples
+	double std = 0;
+
+	//Time keeping variables
+    clock_t startTime, endTime;
+
+	//Wall time at which sampling started, used for the sampling time cap
+	time_t samplingStart = time(NULL);
+
+    //Random seed for random values
+    srand(time(NULL));
+
+	pthread_rwlock_init(&rwlock, NULL);
+
+	for(sampleNumber = 0; sampleNumber < noOfSamples; sampleNumber++){
+
+		//Defining threads
+		pthread_t* threadHandlers;
+		threadHandlers = malloc(sizeof(pthread_t) * noOfThreads);
+
+		// Calculating the total number of each operation
+		noOfInsert = mInsert * m;
+		noOfDelete = mDelete * m;
+		noOfMember = mMember * m;
+
+		int *threadId;
+		threadId = (int *)malloc(sizeof(int) * noOfThreads);
+
+		resetPeakRss();
+
+		//Populating the set with random values
+		create();
+		populate(n);
+
+		//Recording time at operations start
+		startTime = clock();
+		sampleClockStart();
+		sampleClockThreads(noOfThreads);
+
+		// Thread Creation
+		int i = 0;
+		for (i = 0; i < noOfThreads; i++) {
+			threadId[i] = i;
+			pthread_create(&threadHandlers[i], NULL, threadOperation, (void *) &threadId[i]);
+		}
+
+		// Thread Join
+		for (i = 0; i < noOfThreads; i++) {
+			pthread_join(threadHandlers[i], NULL);
+		}
+
+		//Recording the time at operation ends
+		endTime = clock();
+		sampleClockStop();
+
+		//Timing the ordered iteration and the range counts on the final set
+		timeQueries();
+
+		//Deallocate the memory of this sample's set
+		measureMemory();
+		destroy();
+
+		//Deallocate the memory of this sample's thread handlers
+		free(threadHandlers);
+		free(threadId);
+
+		sampleTime = sampleClockTime(calcTime(startTime, endTime));
+		addSample(sampleTime);
+
+		//Stop as soon as the confidence target is met
+		if (isConfidenceReached())
+			break;
+
+		//Stop if the sampling time cap is exceeded
+		if (difftime(time(NULL), samplingStart) > MAX_SAMPLING_TIME)
+			break;
+	}
+
+	pthread_rwlock_destroy(&rwlock);
+
+	//Calculate mean for all the samples
+	mean = runningMean;
+
+	//Calculate Standard deviation for all the samples
+	std = findStd();
+
+	writeOutput(mean, std);
+	writeRecord(backend == BACKEND_BITMAP ? "bitmap" : "bitmap-fallback-rw", noOfThreads, n, m, mMember, mInsert, mDelete, mean, std);
+
+    return 0;
+}
+
+//Set the bit of index at a level, and the summary bits above it when its word was empty
+//Returns 1 if the bit was clear
+int bitmapSet(int level, long index) {
+    unsigned long mask = 1UL << (index & 63);
+    unsigned long old = __atomic_fetch_or(&levels[level][index >> 6], mask, __ATOMIC_ACQ_REL);
+
+    if (old == 0 && level + 1 < levelCount)
+        bitmapSet(level + 1, index >> 6);
+    return (old & mask) == 0;
+}
+
+//Clear the bit of index at a level, and the summary bit of its word when it became empty
+//The summary bit is set again if another thread refilled the word meanwhile
+//Returns 1 if the bit was set
+int bitmapClear(int level, long index) {
+    unsigned long mask = 1UL << (index & 63);
+    unsigned long *word_p = &levels[level][index >> 6];
+    unsigned long old = __atomic_fetch_and(word_p, ~mask, __ATOMIC_ACQ_REL);
+
+    if (old == mask && level + 1 < levelCount) {
+        bitmapClear(level + 1, index >> 6);
+        if (__atomic_load_n(word_p, __ATOMIC_ACQUIRE) != 0)
+            bitmapSet(level + 1, index >> 6);
+    }
+    return (old & mask) != 0;
+}
+
+//Smallest key of the set at or above key, -1 if there is none
+long bitmapNext(long key) {
+    unsigned long word;
+    long index;
+    int level;
+
+    while (key < keyRange) {
+
+        //Climbing until a word holds a set bit at or after index
+        index = key;
+        for (level = 0; ; level++) {
+            if ((index >> 6) >= levelWords[level])
+                return -1;
+            word = __atomic_load_n(&levels[level][index >> 6], __ATOMIC_ACQUIRE) & (~0UL << (index & 63));
+            if (word != 0)
+                break;
+            if (level + 1 == levelCount)
+                return -1;
+            index = (index >> 6) + 1;
+        }
+        index = (index & ~63L) | __builtin_ctzl(word);
+
+        //Descending through the first set bit of every level
+        while (level > 0) {
+            level--;
+            word = __atomic_load_n(&levels[level][index], __ATOMIC_ACQUIRE);
+            if (word == 0)
+                break;
+            index = (index << 6) | __builtin_ctzl(word);
+        }
+        if (word != 0)
+            return index;
+
+        //A stale summary bit, going on after the keys of the empty word
+        key = (index + 1) << (6 * (level + 1));
+    }
+    return -1;
+}
+
+//Number of keys of the set in [lo, hi), popcounting the leaf words under set summary bits
+long bitmapRangeCount(long lo, long hi) {
+    long first = lo >> 6, last = (hi - 1) >> 6, count = 0, s, w;
+    unsigned long summary, word;
+
+    if (hi <= lo)
+        return 0;
+
+    for (s = first >> 6; s <= last >> 6; s++) {
+        summary = levelCount > 1 ? __atomic_load_n(&levels[1][s], __ATOMIC_ACQUIRE) : ~0UL;
+        while (summary != 0) {
+            w = (s << 6) | __builtin_ctzl(summary);
+            summary &= summary - 1;
+            if (w < first || w > last || w >= levelWords[0])
+                continue;
+            word = __atomic_load_n(&levels[0][w], __ATOMIC_ACQUIRE);
+            if (w == first)
+                word &= ~0UL << (lo & 63);
+            if (w == last && (hi & 63) != 0)
+                word &= ~0UL >> (64 - (hi & 63));
+            count += __builtin_popcountl(word);
+        }
+    }
+    return count;
+}
+
+// Linked List Membership function
+int listMember(int value) {
+    struct list_node_s *current_p;
+    int found;
+
+    pthread_rwlock_rdlock(&rwlock);
+    current_p = head;
+    while (current_p != NULL && current_p->data < value)
+        current_p = current_p->next;
+    found = current_p != NULL && current_p->data == value;
+    pthread_rwlock_unlock(&rwlock);
+    return found;
+}
+
+// Linked List Insertion function
+int listInsert(int value) {
+    struct list_node_s *curr_p, *pred_p = NULL, *temp_p;
+
+    pthread_rwlock_wrlock(&rwlock);
+    curr_p = head;
+    while (curr_p != NULL && curr_p->data < value) {
+        pred_p = curr_p;
+        curr_p = curr_p->next;
+    }
+
+    if (curr_p != NULL && curr_p->data == value) {
+        pthread_rwlock_unlock(&rwlock);
+        return 0;
+    }
+
+    temp_p = malloc(sizeof(struct list_node_s));
+    temp_p->data = value;
+    temp_p->next = curr_p;
+    if (pred_p == NULL)
+        head = temp_p;
+    else
+        pred_p->next = temp_p;
+    pthread_rwlock_unlock(&rwlock);
+    return 1;
+}
+
+// Linked List Deletion function
+int listDelete(int value) {
+    struct list_node_s *curr_p, *pred_p = NULL;
+
+    pthread_rwlock_wrlock(&rwlock);
+    curr_p = head;
+    while (curr_p != NULL && curr_p->data < value) {
+        pred_p = curr_p;
+        curr_p = curr_p->next;
+    }
+
+    if (curr_p == NULL || curr_p->data != value) {
+        pthread_rwlock_unlock(&rwlock);
+        return 0;
+    }
+
+    if (pred_p == NULL)
+        head = curr_p->next;
+    else
+        pred_p->next = curr_p->next;
+    pthread_rwlock_unlock(&rwlock);
+    free(curr_p);
+    return 1;
+}
+
+//Number of keys of the list in [lo, hi)
+long listRangeCount(long lo, long hi) {
+    struct list_node_s *curr_p;
+    long count = 0;
+
+    pthread_rwlock_rdlock(&rwlock);
+    for (curr_p = head; curr_p != NULL && curr_p->data < hi; curr_p = curr_p->next)
+        if (curr_p->data >= lo)
+            count++;
+    pthread_rwlock_unlock(&rwlock);
+    return count;
+}
+
+int Member(int value) {
+    if (backend == BACKEND_LIST)
+        return listMember(value);
+    return (__atomic_load_n(&levels[0][value >> 6], __ATOMIC_ACQUIRE) >> (value & 63)) & 1;
+}
+
+int Insert(int value) {
+    if (backend == BACKEND_LIST)
+        return listInsert(value);
+    return bitmapSet(0, value);
+}
+
+int Delete(int value) {
+    if (backend == BACKEND_LIST)
+        return listDelete(value);
+    return bitmapClear(0, value);
+}
+
+//Number of keys met by an ordered iteration over the whole set
+long orderedCount() {
+    struct list_node_s *curr_p;
+    long count = 0, key;
+
+    if (backend == BACKEND_LIST) {
+        for (curr_p = head; curr_p != NULL; curr_p = curr_p->next)
+            count++;
+        return count;
+    }
+
+    for (key = bitmapNext(0); key >= 0; key = bitmapNext(key + 1))
+        count++;
+    return count;
+}
+
+long rangeCount(long lo, long hi) {
+    if (backend == BACKEND_LIST)
+        return listRangeCount(lo, hi);
+    return bitmapRangeCount(lo, hi);
+}
+
+//Allocate an empty set, every level of the bitmap down to a single word
+void create() {
+    long words = (keyRange + 63) / 64;
+
+    if (backend == BACKEND_LIST) {
+        head = NULL;
+        return;
+    }
+
+    for (levelCount = 0; levelCount < BITMAP_LEVELS; levelCount++) {
+        levels[levelCount] = calloc(words, sizeof(unsigned long));
+        levelWords[levelCount] = words;
+        if (words == 1) {
+            levelCount++;
+            break;
+        }
+        words = (words + 63) / 64;
+    }
+}
+
+void destroy() {
+    struct list_node_s *curr_p = head;
+    struct list_node_s *next_p;
+    int level;
+
+    while (curr_p != NULL) {
+        next_p = curr_p->next;
+        free(curr_p);
+        curr_p = next_p;
+    }
+    head = NULL;
+
+    for (level = 0; level < levelCount; level++) {
+        free(levels[level]);
+        levels[level] = NULL;
+    }
+    levelCount = 0;
+}
+
+//Record the memory footprint of the set at the end of a sample
+//The bitmap takes the same space whatever the number of keys
+void measureMemory() {
+    struct list_node_s *curr_p;
+    long live = 0;
+    double requested = 0.0, allocated = 0.0;
+    int level;
+
+    if (backend == BACKEND_LIST) {
+        for (curr_p = head; curr_p != NULL; curr_p = curr_p->next) {
+            live++;
+            allocated += allocatedSize(curr_p);
+        }
+        recordMemory(live, (double) live * sizeof(struct list_node_s), allocated, 0.0);
+        return;
+    }
+
+    live = bitmapRangeCount(0, keyRange);
+    for (level = 0; level < levelCount; level++) {
+        requested += levelWords[level] * sizeof(unsigned long);
+        allocated += allocatedSize(levels[level]);
+    }
+    recordMemory(live, requested, allocated, 0.0);
+}
+
+//Time a full ordered iteration and RANGE_QUERIES range counts of the set
+//The iteration has to meet every key counted over the whole range
+void timeQueries() {
+    double start;
+    long count, lo;
+    int i;
+
+    start = wallTime();
+    count = orderedCount();
+    iterationTime += wallTime() - start;
+    iteratedKeys += count;
+    if (count != rangeCount(0, keyRange))
+        iterationMismatches++;
+
+    start = wallTime();
+    for (i = 0; i < RANGE_QUERIES; i++) {
+        lo = rand() % keyRange;
+        rangeCount(lo, lo + RANGE_WIDTH < keyRange ? lo + RANGE_WIDTH : keyRange);
+    }
+    rangeTime += wallTime() - start;
+}
+
+//Retrieve and validate the inputs
+void validateInput(int argc, char *argv[]) {
+
+
+    if (argc != 8 && argc != 9) {
+        printf("Enter the command with arguments noOfSamples, n, m, noOfThreads, mMember, mInsert, mDelete and optionally keyRange\n");
+        exit(0);
+    }
+
+    //Input retrieval
+	noOfSamples = (int) strtol(argv[1], (char**) NULL, 10);
+    n = (int) strtol(argv[2], (char**) NULL, 10);
+    m = (int) strtol(argv[3], (char**) NULL, 10);
+	noOfThreads = (int) strtol(argv[4], (char**) NULL, 10);
+    mMember = (float) atof(argv[5]);
+    mInsert = (float) atof(argv[6]);
+    mDelete = (float) atof(argv[7]);
+    if (argc == 9)
+        keyRange = (int) strtol(argv[8], (char**) NULL, 10);
+
+    //Input validation
+	if (noOfSamples <= 0){
+		printf("Invalid input for noOfSamples (noOfSamples > 0)\n");
+		exit(0);
+	} else if (n <= 0 || n > RAND_MAX / 2){
+		printf("Invalid input for n (0 < n <= %d)\n", RAND_MAX / 2);
+		exit(0);
+	}else if (m <= 0){
+		printf("Invalid input for m (m > 0)\n");
+		exit(0);
+
+	}else if (mMember + mInsert + mDelete != 1.0){
+		printf("Invalid combination of fractions (Total = 1.0)\n");
+		exit(0);
+	}else if (keyRange <= n){
+		printf("Invalid input for keyRange (keyRange > n)\n");
+		exit(0);
+	}
+
+    //Input validation
+    if (noOfThreads <= 0 || noOfThreads > MAX_THREADS) {
+        printf("Invalid no. of Threads (0 < noOfThreads < %d)", MAX_THREADS);
+        exit(0);
+    }
+
+    //A bounded small universe goes to the bitmap
+    backend = keyRange <= BITMAP_MAX_KEYS ? BACKEND_BITMAP : BACKEND_LIST;
+}
+
+// Thread Operations
+// Each thread runs its share of each operation, picked in proportion to what is left,
+// with its own random state as rand() would serialize the threads on its lock
+void *threadOperation(void *threadId) {
+    int id = *(int *)threadId;
+    unsigned int seed = (unsigned int) time(NULL) ^ (id << 16);
+
+    //Number of each operations allocated for the thread
+    int memberLeft = noOfMember / noOfThreads + (noOfMember % noOfThreads > id ? 1 : 0);
+    int insertLeft = noOfInsert / noOfThreads + (noOfInsert % noOfThreads > id ? 1 : 0);
+    int deleteLeft = noOfDelete / noOfThreads + (noOfDelete % noOfThreads > id ? 1 : 0);
+
+    sampleClockThreadStart();
+
+    while (memberLeft + insertLeft + deleteLeft > 0) {
+
+        int randomNumber = rand_r(&seed) % keyRange;
+        int randomOperation = rand_r(&seed) % (memberLeft + insertLeft + deleteLeft);
+
+        if (randomOperation < memberLeft) {
+            Member(randomNumber);
+            memberLeft--;
+        }
+        else if (randomOperation < memberLeft + insertLeft) {
+            Insert(randomNumber);
+            insertLeft--;
+        }
+        else {
+            Delete(randomNumber);
+            deleteLeft--;
+        }
+    }
+    return NULL;
+}
+
+//Wall clock time in seconds
+double wallTime() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//Set population function
+void populate(int n){
+
+	int i;
+
+	for(i=0; i<n; ){
+		if(Insert(rand() % keyRange) == 1)
+			i++;
+	}
+}
+
+//Calculating time between operation start and end
+double calcTime(clock_t startTime, clock_t endTime) {
+    return (double) (endTime - startTime) / CLOCKS_PER_SEC;
+}
+
+void writeOutput(double mean, double std) {
+	int samples = acceptedSamples + rejectedSamples;
+	long words = (keyRange + 63) / 64, bytes = 0;
+	int used = 0;
+	FILE *f = fopen("results.txt", "a");
+	if (f == NULL)
+	{
+		printf("Error occured while opening the file \n");
+		exit(1);
+	}
+
+	fprintf(f,"\n === Atomic Bitmap Set === \n\n");
+	fprintf(f,"Number of Nodes = %d\n", n);
+	fprintf(f,"Number of Operations = %d\n", m);
+	fprintf(f,"Member Fraction= %.2f\n", mMember);
+	fprintf(f,"Insert Fraction = %.3f\n", mInsert);
+	fprintf(f,"Delete Fraction = %.3f\n", mDelete);
+	fprintf(f,"Number of Threads = %d\n", noOfThreads);
+	if (backend == BACKEND_BITMAP) {
+		for (used = 0; used < BITMAP_LEVELS; used++) {
+			bytes += words * sizeof(unsigned long);
+			if (words == 1) {
+				used++;
+				break;
+			}
+			words = (words + 63) / 64;
+		}
+		fprintf(f,"Backend = bitmap of %d keys, %d levels, %ld bytes\n", keyRange, used, bytes);
+	} else {
+		fprintf(f,"Backend = read write lock list, %d keys are above the bitmap limit of %d\n", keyRange, BITMAP_MAX_KEYS);
+	}
+	fprintf(f,"Max Number of Samples = %d\n", noOfSamples);
+	fprintf(f,"Number of Samples = %d\n", acceptedSamples);
+	fprintf(f,"Rejected Outliers = %d\n", rejectedSamples);
+	fprintf(f,"Min number of samples needed = %f\n", minNoOfSamples);
+	fprintf(f,"Mean = %f\n", mean);
+	fprintf(f,"Standard Deviation = %f\n", std);
+	fprintf(f,"Throughput (ops/sec) = %f\n", mean > 0 ? m / mean : 0.0);
+	fprintf(f,"Confidence Interval (95%%) = +/- %f (%.2f%% of mean)\n", 1.96*std/sqrt(acceptedSamples), mean > 0 ? 100*1.96*std/sqrt(acceptedSamples)/mean : 0.0);
+	if (samples > 0) {
+		fprintf(f,"Ordered Iteration = %f sec for %.0f keys, %s the range count\n", iterationTime / samples,
+				(double) iteratedKeys / samples, iterationMismatches == 0 ? "matches" : "DOES NOT MATCH");
+		fprintf(f,"Range Count (width %d) = %f usec per query\n", RANGE_WIDTH, 1e6 * rangeTime / samples / RANGE_QUERIES);
+	}
+	writeMemoryStats(f);
+	fprintf(f,"________________________________________ \n\n");
+
+	fclose(f);
+}
@@ -0,0 +1,451 @@
+/*
+ * Sequential Linked List with a compact, index based node layout
+ *
+ * Nodes live in one contiguous array and are linked by 32-bit indices instead of
+ * pointers, so a node takes 8 bytes instead of 16. The layout and the prefetching can
+ * be changed separately, so that each effect is measured on its own :
+ *
+ *   layout 0 = sorted : the populated nodes are in list order in the array, so a
+ *              traversal walks the array forwards
+ *   layout 1 = shuffled : the populated nodes are in random array slots, as the serial
+ *              list's nodes are in random allocation order
+ *
+ *   prefetchMode 0 = off
+ *   prefetchMode 1 = links : once a hop has loaded a node, the node after it is
+ *              prefetched through its next index. The traversal is a chain of dependent
+ *              loads, so this only overlaps that miss with the key comparison.
+ *
+ * Compile : gcc -g -Wall -o compact_linked_list compact_linked_list.c -lm
+ * Run : ./compact_linked_list noOfSamples n m mMember mInsert mDelete [layout [prefetchMode]]
+ *
+ * */
+ 
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h> 
+#include <math.h>
+
+#include "sample_stats.h"
+
+#define MAX_RANDOM 65535
+
+//Index marking the end of the list
+#define NIL UINT32_MAX
+
+#define LAYOUT_SORTED 0
+#define LAYOUT_SHUFFLED 1
+
+#define PREFETCH_OFF 0
+#define PREFETCH_LINKS 1
+
+// Number of samples
+int noOfSamples = 0;
+
+// Number of nodes in the linked list
+int n = 0;
+
+// Keys are drawn from [0, keyRange), widened beyond MAX_RANDOM for large n
+int keyRange = MAX_RANDOM;
+
+// Number of random operations in the linked list
+int m = 0;
+
+// Fractions of each operation
+float mInsert, mDelete, mMember;
+
+// Order of the populated nodes in the array
+int layout = LAYOUT_SORTED;
+
+// Whether traversals prefetch along the links
+int prefetchMode = PREFETCH_OFF;
+
+//Node definition
+struct list_node_s {
+    int data;
+    uint32_t next;
+};
+
+//List definition, nodes are addressed by their index in the nodes array
+struct list_s {
+    struct list_node_s *nodes;
+    uint32_t head;
+    uint32_t capacity;
+    //Number of array slots handed out so far
+    uint32_t used;
+    //Deleted slots, linked through their next index
+    uint32_t freeList;
+};
+
+struct list_s list;
+
+int Insert(int value, struct list_s *list_p);
+
+int Delete(int value, struct list_s *list_p);
+
+int Member(int value, struct list_s *list_p);
+
+uint32_t allocNode(struct list_s *list_p);
+
+void freeNode(struct list_s *list_p, uint32_t node);
+
+void validateInput(int argc, char *argv[]);
+
+double calcTime(clock_t startTime, clock_t endTime);
+
+void populate(int n, struct list_s *list_p);
+
+void writeOutput(double mean, double std) ;
+
+int main(int argc, char *argv[]) {
+	
+	
+	//Retrieve and validate inputs
+	validateInput(argc, argv);
+	
+	int sampleNumber = 0;
+	
+	//Time spend for a particular sample
+	double sampleTime = 0;
+	
+	//Mean of times of all the samples
+	double mean = 0;
+	
+	//Standard deviation of all the samples
+	double std = 0;  
+	
+	//Time keeping variables 
+    clock_t startTime, endTime;
+	
+	//Wall time at which sampling started, used for the sampling time cap
+	time_t samplingStart = time(NULL);
+    
+    //Random seed for random values
+	srand(time(NULL));
+	
+	for(sampleNumber = 0; sampleNumber < noOfSamples; sampleNumber++){
+		
+		//Populating linked list with random values	
+		populate(n,&list);
+		
+		//Excecuted number of each operations in the linked list
+		int totalExecuted = 0;
+		int memberExecuted = 0;
+		int insertExecuted = 0;
+		int deleteExecuted = 0;
+		
+		//Total number of times to be executed for each operation
+		float noOfInsert = mInsert * m;
+		float noOfDelete = mDelete * m;
+		float noOfMember = mMember * m;
+		
+		//Recording time at operations start
+		startTime = clock();
+		
+		while (totalExecuted < m) {
+			
+			//Random number to be used in the operation
+			int randomNumber = rand() % keyRange;
+			
+			//Select the operation randomly
+			int randomOperation = rand() % 3;
+
+			if (randomOperation == 0 && memberExecuted < noOfMember) {
+				Member(randomNumber, &list);
+				memberExecuted++;
+			}
+
+			if (randomOperation == 1 && insertExecuted < noOfInsert) {
+				Insert(randomNumber, &list);
+				insertExecuted++;
+			}
+
+			else if (randomOperation == 2 && deleteExecuted < noOfDelete) {
+				Delete(randomNumber, &list);
+				deleteExecuted++;
+			}
+			
+			//Calculate the total number of executions ran so far
+			totalExecuted = insertExecuted + memberExecuted + deleteExecuted;
+		}
+		
+		//Recording the time at operation ends
+		endTime = clock();
+		
+		//Deallocate the memory of this sample's linked list
+		free(list.nodes);
+		
+		sampleTime = calcTime(startTime, endTime);
+		addSample(sampleTime);
+		//printf("Average of sample %d  = %f\n",sampleNumber,sampleTime);		
+
+		//Stop as soon as the confidence target is met
+		if (isConfidenceReached())
+			break;
+
+		//Stop if the sampling time cap is exceeded
+		if (difftime(time(NULL), samplingStart) > MAX_SAMPLING_TIME)
+			break;
+	}
+	
+	//Calculate mean for all the samples
+	mean = runningMean;
+	
+	//Calculate Standard deviation for all the samples
+	std = findStd();
+	
+	writeOutput(mean, std);
+	char variant[64];
+	snprintf(variant, sizeof(variant), "compact%s%s", layout == LAYOUT_SHUFFLED ? "-shuffled" : "",
+			prefetchMode == PREFETCH_LINKS ? "-prefetch" : "");
+	writeRecord(variant, 1, n, m, mMember, mInsert, mDelete, mean, std);
+	//printf("Average time spent = %f\n",mean);
+	//printf("Standard Deviation = %f\n",(std));
+  
+    //printf("Total time spent : %.6f secs\n", calcTime(startTime, endTime));
+    return 0;
+}
+
+
+//Prefetch the successor of the node a hop has just reached, following its next index
+static inline void prefetchAhead(struct list_s *list_p, uint32_t next) {
+    uint32_t after;
+
+    if (prefetchMode != PREFETCH_LINKS || next == NIL)
+        return;
+    after = list_p->nodes[next].next;
+    if (after != NIL)
+        __builtin_prefetch(&list_p->nodes[after]);
+}
+
+//Linked List Membership function
+int Member(int value, struct list_s *list_p) {
+    struct list_node_s *nodes = list_p->nodes;
+    uint32_t curr = list_p->head;
+
+    while (curr != NIL && nodes[curr].data < value) {
+        curr = nodes[curr].next;
+        prefetchAhead(list_p, curr);
+    }
+
+    if (curr == NIL || nodes[curr].data > value) {
+        return 0;
+    }
+    else
+        return 1;
+}
+
+//Linked List Insertion function
+int Insert(int value, struct list_s *list_p) {
+    uint32_t curr = list_p->head;
+    uint32_t pred = NIL;
+    uint32_t temp = NIL;
+
+    while (curr != NIL && list_p->nodes[curr].data < value) {
+        pred = curr;
+        curr = list_p->nodes[curr].next;
+        prefetchAhead(list_p, curr);
+    }
+
+    if (curr == NIL || list_p->nodes[curr].data > value) {
+        temp = allocNode(list_p);
+        list_p->nodes[temp].data = value;
+        list_p->nodes[temp].next = curr;
+
+        if (pred == NIL)
+            list_p->head = temp;
+        else
+            list_p->nodes[pred].next = temp;
+
+        return 1;
+    }
+    else
+        return 0;
+}
+
+
+//Linked List Deletion function
+int Delete(int value, struct list_s *list_p) {
+    uint32_t curr = list_p->head;
+    uint32_t pred = NIL;
+
+    while (curr != NIL && list_p->nodes[curr].data < value) {
+        pred = curr;
+        curr = list_p->nodes[curr].next;
+        prefetchAhead(list_p, curr);
+    }
+
+    if (curr != NIL && list_p->nodes[curr].data == value) {
+        if (pred == NIL)
+            list_p->head = list_p->nodes[curr].next;
+        else
+            list_p->nodes[pred].next = list_p->nodes[curr].next;
+        freeNode(list_p, curr);
+        return 1;
+    }
+    else
+        return 0;
+}
+
+//Take a slot from the free list, or from the end of the array (doubling it when full)
+uint32_t allocNode(struct list_s *list_p) {
+    uint32_t node;
+
+    if (list_p->freeList != NIL) {
+        node = list_p->freeList;
+        list_p->freeList = list_p->nodes[node].next;
+        return node;
+    }
+
+    if (list_p->used == list_p->capacity) {
+        list_p->capacity = list_p->capacity > 0 ? 2 * list_p->capacity : 64;
+        list_p->nodes = realloc(list_p->nodes, sizeof(struct list_node_s) * list_p->capacity);
+        if (list_p->nodes == NULL) {
+            printf("Error occured while allocating the nodes \n");
+            exit(1);
+        }
+    }
+    return list_p->used++;
+}
+
+//Return a slot to the free list
+void freeNode(struct list_s *list_p, uint32_t node) {
+    list_p->nodes[node].next = list_p->freeList;
+    list_p->freeList = node;
+}
+
+//Linked list population function
+//The n random keys are linked in sorted order, the array slots they take are in the
+//same order for the sorted layout and in a random permutation for the shuffled one
+void populate(int n, struct list_s *list_p)
+{
+  int num,i,j;
+  uint32_t slot;
+  char *used = calloc(keyRange, sizeof(char));
+  uint32_t *slots = malloc(sizeof(uint32_t) * n);
+
+  for(i=0; i<n; ){
+    num = rand() % keyRange;
+    if(used[num])
+      continue;
+    used[num] = 1;
+    i++;
+  }
+
+  list_p->capacity = n + n / 2;
+  list_p->nodes = malloc(sizeof(struct list_node_s) * list_p->capacity);
+  list_p->used = 0;
+  list_p->freeList = NIL;
+  list_p->head = NIL;
+
+  for(i=0; i<n; i++)
+    slots[i] = allocNode(list_p);
+
+  //Fisher-Yates shuffle of the slots
+  if(layout == LAYOUT_SHUFFLED){
+    for(i=n-1; i>0; i--){
+      j = rand() % (i + 1);
+      slot = slots[i];
+      slots[i] = slots[j];
+      slots[j] = slot;
+    }
+  }
+
+  for(num=0, i=0; num<keyRange; num++){
+    if(!used[num])
+      continue;
+    list_p->nodes[slots[i]].data = num;
+    list_p->nodes[slots[i]].next = NIL;
+    if(i == 0)
+      list_p->head = slots[i];
+    else
+      list_p->nodes[slots[i-1]].next = slots[i];
+    i++;
+  }
+
+  free(slots);
+  free(used);
+}
+
+//Retrieve and validate the inputs
+void validateInput(int argc, char *argv[]) {
+		
+    if (argc < 7 || argc > 9) {
+        printf("Enter the command with arguments noOfSamples, n, m, mMember, mInsert, mDelete and optionally layout and prefetchMode\n");
+        exit(0);
+    }
+    
+    //Input retrieval
+	noOfSamples = (int) strtol(argv[1], (char **) NULL, 10);
+    n = (int) strtol(argv[2], (char **) NULL, 10);
+    m = (int) strtol(argv[3], (char **) NULL, 10);
+
+    mMember = (float) atof(argv[4]);
+    mInsert = (float) atof(argv[5]);
+    mDelete = (float) atof(argv[6]);
+    if (argc >= 8)
+        layout = (int) strtol(argv[7], (char **) NULL, 10);
+    if (argc >= 9)
+        prefetchMode = (int) strtol(argv[8], (char **) NULL, 10);
+
+    //Input validation
+	if (noOfSamples <= 0){
+		printf("Invalid input for noOfSamples (noOfSamples > 0)\n");
+		exit(0);
+	} else if (n <= 0){
+		printf("Invalid input for n (n > 0)\n");
+		exit(0);
+	}else if (m <= 0){
+		printf("Invalid input for m (m > 0)\n");
+		exit(0);
+
+	}else if (mMember + mInsert + mDelete != 1.0){
+		printf("Invalid combination of fractions (Total = 1.0)\n");
+		exit(0);
+	}else if (layout < LAYOUT_SORTED || layout > LAYOUT_SHUFFLED){
+		printf("Invalid layout (0 = sorted, 1 = shuffled)\n");
+		exit(0);
+	}else if (prefetchMode < PREFETCH_OFF || prefetchMode > PREFETCH_LINKS){
+		printf("Invalid prefetchMode (0 = off, 1 = links)\n");
+		exit(0);
+	}
+
+	//Keep the list at most half full of the key range
+	if (n > MAX_RANDOM / 2)
+		keyRange = 2 * n;
+}
+
+//Calculating time between operation start and end
+double calcTime(clock_t startTime, clock_t endTime) {
+    return (double) (endTime - startTime) / CLOCKS_PER_SEC;
+}
+
+void writeOutput(double mean, double std) {
+	FILE *f = fopen("results.txt", "a"); 
+	if (f == NULL)
+	{
+		printf("Error occured while opening the file \n");        
+		exit(1);
+	}
+	
+	fprintf(f,"\n === Compact Serial === \n\n"); 
+	fprintf(f,"Number of Nodes = %d\n", n);
+	fprintf(f,"Number of Operations = %d\n", m);
+	fprintf(f,"Member Fraction= %.2f\n", mMember);  
+	fprintf(f,"Insert Fraction = %.3f\n", mInsert);  
+	fprintf(f,"Delete Fraction = %.3f\n", mDelete); 
+	fprintf(f,"Node Layout = %s\n", layout == LAYOUT_SHUFFLED ? "shuffled" : "sorted");
+	fprintf(f,"Prefetch = %s\n", prefetchMode == PREFETCH_LINKS ? "links" : "off");
+	fprintf(f,"Max Number of Samples = %d\n", noOfSamples);
+	fprintf(f,"Number of Samples = %d\n", acceptedSamples);
+	fprintf(f,"Rejected Outliers = %d\n", rejectedSamples);
+	fprintf(f,"Min number of samples needed = %f\n", minNoOfSamples);  
+	fprintf(f,"Mean = %f\n", mean);  
+	fprintf(f,"Standard Deviation = %f\n", std);
+	fprintf(f,"Throughput (ops/sec) = %f\n", mean > 0 ? m / mean : 0.0);
+	fprintf(f,"Confidence Interval (95%%) = +/- %f (%.2f%% of mean)\n", 1.96*std/sqrt(acceptedSamples), mean > 0 ? 100*1.96*std/sqrt(acceptedSamples)/mean : 0.0);
+	fprintf(f,"________________________________________ \n\n");                   
+	
+	fclose(f); 
+}
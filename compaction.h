@@ -0,0 +1,189 @@
+/*
+ * Compaction of the pointer based lists
+ *
+ * After many Insert/Delete calls the node addresses are random relative to the list
+ * order. Compaction copies the live nodes into one contiguous region in list order,
+ * so that traversals walk memory sequentially again. Nodes inside a region are never
+ * freed one by one, the whole region is freed by the compaction that replaces it.
+ *
+ * struct list_node_s has to be defined before this file is included. The list
+ * functions call noteInserted(), noteDeleted() and freeNode() while holding the
+ * list's exclusive lock, which keeps the fragmentation counters consistent.
+ *
+ * */
+#ifndef COMPACTION_H
+#define COMPACTION_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+//Compaction modes, given as the optional last argument
+#define COMPACT_OFF 0
+#define COMPACT_EXPLICIT 1
+#define COMPACT_BACKGROUND 2
+
+//Fraction of scattered nodes above which the background thread compacts
+#define COMPACT_THRESHOLD 0.25
+
+//Period (microseconds) at which the background thread checks the fragmentation
+#define COMPACT_INTERVAL 1000
+
+//Contiguous block holding compacted nodes
+struct region_s {
+    struct list_node_s *nodes;
+    long count;
+};
+
+static int compactMode = COMPACT_OFF;
+
+//Region of the current list
+static struct region_s region = {NULL, 0};
+
+//Live nodes, and live nodes or holes which break the contiguous order
+static long liveNodes = 0;
+static long scatteredNodes = 0;
+
+//Deleted region nodes, retired but only freed with their region
+static long retiredNodes = 0;
+
+//Number of successful Insert/Delete calls, used to validate a copy
+static unsigned long modifications = 0;
+
+//Compaction statistics of the run
+static long compactions = 0;
+static double pauseTotal = 0.0, pauseMax = 0.0;
+static double traverseBefore = 0.0, traverseAfter = 0.0;
+static int traverseSamples = 0;
+
+static inline double compactNow() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static inline int isInRegion(struct region_s *region_p, struct list_node_s *node_p) {
+    return node_p >= region_p->nodes && node_p < region_p->nodes + region_p->count;
+}
+
+//Start a sample with a fresh, uncompacted list
+static inline void resetCompaction() {
+    region.nodes = NULL;
+    region.count = 0;
+    liveNodes = 0;
+    scatteredNodes = 0;
+    retiredNodes = 0;
+    modifications = 0;
+}
+
+static inline void noteInserted() {
+    liveNodes++;
+    scatteredNodes++;
+    modifications++;
+}
+
+static inline void noteDeleted(struct list_node_s *node_p) {
+    liveNodes--;
+    //A deleted region node leaves a hole, a deleted scattered node removes one
+    if (isInRegion(&region, node_p)) {
+        scatteredNodes++;
+        retiredNodes++;
+    } else
+        scatteredNodes--;
+    modifications++;
+}
+
+//Free a node unless it belongs to the current region
+static inline void freeNode(struct list_node_s *node_p) {
+    if (!isInRegion(&region, node_p))
+        free(node_p);
+}
+
+static inline double fragmentation() {
+    return liveNodes > 0 ? (double) scatteredNodes / liveNodes : 0.0;
+}
+
+//Copy the list into a new contiguous region and return the new first node
+static inline struct list_node_s *copyList(struct list_node_s *head_p, struct region_s *region_p) {
+    struct list_node_s *curr_p;
+    long i = 0;
+
+    region_p->count = 0;
+    for (curr_p = head_p; curr_p != NULL; curr_p = curr_p->next)
+        region_p->count++;
+
+    if (region_p->count == 0) {
+        region_p->nodes = NULL;
+        return NULL;
+    }
+
+    region_p->nodes = malloc(sizeof(struct list_node_s) * region_p->count);
+    if (region_p->nodes == NULL) {
+        printf("Error occured while allocating the compaction region \n");
+        exit(1);
+    }
+
+    for (curr_p = head_p; curr_p != NULL; curr_p = curr_p->next, i++) {
+        region_p->nodes[i].data = curr_p->data;
+        region_p->nodes[i].next = &region_p->nodes[i + 1];
+    }
+    region_p->nodes[region_p->count - 1].next = NULL;
+
+    return region_p->nodes;
+}
+
+//Free a list which is no longer reachable, together with its region
+static inline void releaseList(struct list_node_s *head_p, struct region_s *region_p) {
+    struct list_node_s *curr_p = head_p;
+    struct list_node_s *next_p;
+
+    while (curr_p != NULL) {
+        next_p = curr_p->next;
+        if (!isInRegion(region_p, curr_p))
+            free(curr_p);
+        curr_p = next_p;
+    }
+    free(region_p->nodes);
+}
+
+//Time of a full traversal in nanoseconds per node
+static inline double traverseTime(struct list_node_s *head_p) {
+    struct list_node_s *curr_p;
+    volatile long sum = 0;
+    long count = 0;
+    double start = compactNow();
+
+    for (curr_p = head_p; curr_p != NULL; curr_p = curr_p->next) {
+        sum += curr_p->data;
+        count++;
+    }
+    return count > 0 ? (compactNow() - start) * 1e9 / count : 0.0;
+}
+
+static inline void recordCompaction(double pause) {
+    compactions++;
+    pauseTotal += pause;
+    if (pause > pauseMax)
+        pauseMax = pause;
+}
+
+static inline void recordTraversal(double before, double after) {
+    traverseBefore += before;
+    traverseAfter += after;
+    traverseSamples++;
+}
+
+static inline void writeCompactionStats(FILE *f) {
+    if (compactMode == COMPACT_OFF)
+        return;
+
+    fprintf(f,"Compaction Mode = %s\n", compactMode == COMPACT_EXPLICIT ? "explicit" : "background");
+    fprintf(f,"Compactions = %ld\n", compactions);
+    if (compactions > 0)
+        fprintf(f,"Compaction Pause (ms) mean = %f, max = %f\n", 1000 * pauseTotal / compactions, 1000 * pauseMax);
+    if (traverseSamples > 0)
+        fprintf(f,"Traversal (ns per node) before = %f, after = %f\n", traverseBefore / traverseSamples,
+                traverseAfter / traverseSamples);
+}
+
+#endif
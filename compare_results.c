@@ -0,0 +1,274 @@
+/*
+ * Benchmark comparison between two revisions in the benchmark store
+ *
+ * Compile : gcc -g -Wall -o compare_results compare_results.c -lm
+ * Run : ./compare_results baselineRevision candidateRevision [threshold]
+ *
+ * Every configuration (variant, threads, n, m and fractions) present for both revisions
+ * is compared with Welch's t-test. The program exits with 1 if any configuration is
+ * significantly slower than the baseline by more than threshold percent (default 5), and
+ * with 2 if no configuration was measured at both revisions.
+ *
+ * */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define RECORD_FILE "benchmarks.tsv"
+//Records read before the buffer is first grown
+#define INITIAL_RECORDS 4096
+#define MAX_FIELD 64
+
+//Significance level of the t-test
+#define ALPHA 0.05
+
+//Record definition, one line of the benchmark store
+struct record_s {
+    char revision[MAX_FIELD];
+    char variant[MAX_FIELD];
+    int threads;
+    int n;
+    int m;
+    float mMember, mInsert, mDelete;
+    int samples;
+    double mean;
+    double std;
+};
+
+//Records of the two revisions, the store grows without bound
+struct record_s *records = NULL;
+int noOfRecords = 0;
+int recordCapacity = 0;
+
+// Regression threshold as a percentage of the baseline mean
+double threshold = 5.0;
+
+char *baselineRevision = NULL;
+char *candidateRevision = NULL;
+
+void validateInput(int argc, char *argv[]);
+
+void readRecords();
+
+int isSameConfig(struct record_s *a, struct record_s *b);
+
+struct record_s *findLatest(char *revision, struct record_s *config);
+
+double welchTest(struct record_s *a, struct record_s *b);
+
+double betaFraction(double a, double b, double x);
+
+double incompleteBeta(double a, double b, double x);
+
+int main(int argc, char *argv[]) {
+
+    //Retrieve and validate inputs
+    validateInput(argc, argv);
+
+    readRecords();
+
+    int i = 0, j = 0;
+    int compared = 0;
+    int regressions = 0;
+
+    printf("%-8s %7s %8s %8s %6s %6s %6s %12s %12s %9s %9s\n", "variant", "threads", "n", "m",
+           "member", "insert", "delete", "baseline", "candidate", "speedup", "p-value");
+
+    for (i = 0; i < noOfRecords; i++) {
+        struct record_s *base = NULL;
+        struct record_s *cand = NULL;
+        int seen = 0;
+
+        //Only handle each configuration once, at its first appearance
+        for (j = 0; j < i; j++) {
+            if (isSameConfig(&records[i], &records[j])) {
+                seen = 1;
+                break;
+            }
+        }
+        if (seen)
+            continue;
+
+        base = findLatest(baselineRevision, &records[i]);
+        cand = findLatest(candidateRevision, &records[i]);
+        if (base == NULL || cand == NULL)
+            continue;
+
+        double speedup = cand->mean > 0 ? base->mean / cand->mean : 0.0;
+        double change = base->mean > 0 ? 100 * (cand->mean - base->mean) / base->mean : 0.0;
+        double p = welchTest(base, cand);
+        char *verdict = "";
+
+        if (p < ALPHA && change > threshold) {
+            verdict = " REGRESSION";
+            regressions++;
+        } else if (p < ALPHA && change < -threshold) {
+            verdict = " improved";
+        }
+
+        printf("%-8s %7d %8d %8d %6.3f %6.3f %6.3f %12f %12f %8.3fx %9.4f%s\n", base->variant,
+               base->threads, base->n, base->m, base->mMember, base->mInsert, base->mDelete,
+               base->mean, cand->mean, speedup, p, verdict);
+        compared++;
+    }
+
+    printf("\n%d configurations compared, %d regressions beyond %.1f%%\n", compared, regressions, threshold);
+
+    //Nothing compared is not a pass, one of the revisions is missing from the store
+    if (compared == 0) {
+        printf("No configuration was measured at both %s and %s\n", baselineRevision, candidateRevision);
+        return 2;
+    }
+
+    return regressions > 0 ? 1 : 0;
+}
+
+//Retrieve and validate the inputs
+void validateInput(int argc, char *argv[]) {
+
+    if (argc != 3 && argc != 4) {
+        printf("Enter the command with arguments baselineRevision, candidateRevision and optionally threshold\n");
+        exit(2);
+    }
+
+    baselineRevision = argv[1];
+    candidateRevision = argv[2];
+    if (argc == 4)
+        threshold = atof(argv[3]);
+
+    if (threshold < 0) {
+        printf("Invalid input for threshold (threshold >= 0)\n");
+        exit(2);
+    }
+}
+
+//Read the records of the baseline and candidate revisions from the whole benchmark store
+void readRecords() {
+    struct record_s r;
+    FILE *f = fopen(RECORD_FILE, "r");
+    if (f == NULL)
+    {
+        printf("Error occured while opening the file \n");
+        exit(2);
+    }
+
+    for (;;) {
+        int fields = fscanf(f, "%63s %63s %d %d %d %f %f %f %d %lf %lf", r.revision, r.variant,
+                            &r.threads, &r.n, &r.m, &r.mMember, &r.mInsert, &r.mDelete,
+                            &r.samples, &r.mean, &r.std);
+        if (fields != 11)
+            break;
+        if (strcmp(r.revision, baselineRevision) != 0 && strcmp(r.revision, candidateRevision) != 0)
+            continue;
+
+        if (noOfRecords == recordCapacity) {
+            recordCapacity = recordCapacity > 0 ? 2 * recordCapacity : INITIAL_RECORDS;
+            records = realloc(records, sizeof(struct record_s) * recordCapacity);
+            if (records == NULL) {
+                printf("Error occured while allocating the records \n");
+                exit(2);
+            }
+        }
+        records[noOfRecords++] = r;
+    }
+
+    fclose(f);
+}
+
+//Check whether two records describe the same benchmark configuration
+int isSameConfig(struct record_s *a, struct record_s *b) {
+    return strcmp(a->variant, b->variant) == 0 && a->threads == b->threads && a->n == b->n &&
+           a->m == b->m && a->mMember == b->mMember && a->mInsert == b->mInsert &&
+           a->mDelete == b->mDelete;
+}
+
+//Find the most recent record of a configuration for the given revision
+struct record_s *findLatest(char *revision, struct record_s *config) {
+    int i;
+
+    for (i = noOfRecords - 1; i >= 0; i--) {
+        if (strcmp(records[i].revision, revision) == 0 && isSameConfig(&records[i], config))
+            return &records[i];
+    }
+    return NULL;
+}
+
+//Two sided p-value of Welch's t-test between the two records
+double welchTest(struct record_s *a, struct record_s *b) {
+
+    if (a->samples < 2 || b->samples < 2)
+        return 1.0;
+
+    //The store holds population standard deviations, convert to sample variances
+    double varA = a->std * a->std * a->samples / (a->samples - 1);
+    double varB = b->std * b->std * b->samples / (b->samples - 1);
+    double seA = varA / a->samples;
+    double seB = varB / b->samples;
+
+    if (seA + seB == 0)
+        return a->mean == b->mean ? 1.0 : 0.0;
+
+    double t = (a->mean - b->mean) / sqrt(seA + seB);
+    double df = (seA + seB) * (seA + seB) /
+                (seA * seA / (a->samples - 1) + seB * seB / (b->samples - 1));
+
+    return incompleteBeta(df / 2, 0.5, df / (df + t * t));
+}
+
+//Continued fraction for the incomplete beta function (modified Lentz's method)
+double betaFraction(double a, double b, double x) {
+    int i;
+    double c = 1.0, d = 1.0 - (a + b) * x / (a + 1);
+    double h, delta, aa;
+
+    if (fabs(d) < 1e-30)
+        d = 1e-30;
+    d = 1.0 / d;
+    h = d;
+
+    for (i = 1; i <= 200; i++) {
+        int i2 = 2 * i;
+
+        aa = i * (b - i) * x / ((a + i2 - 1) * (a + i2));
+        d = 1.0 + aa * d;
+        if (fabs(d) < 1e-30)
+            d = 1e-30;
+        c = 1.0 + aa / c;
+        if (fabs(c) < 1e-30)
+            c = 1e-30;
+        d = 1.0 / d;
+        h *= d * c;
+
+        aa = -(a + i) * (a + b + i) * x / ((a + i2) * (a + i2 + 1));
+        d = 1.0 + aa * d;
+        if (fabs(d) < 1e-30)
+            d = 1e-30;
+        c = 1.0 + aa / c;
+        if (fabs(c) < 1e-30)
+            c = 1e-30;
+        d = 1.0 / d;
+        delta = d * c;
+        h *= delta;
+
+        if (fabs(delta - 1.0) < 1e-10)
+            break;
+    }
+    return h;
+}
+
+//Regularized incomplete beta function I_x(a, b)
+double incompleteBeta(double a, double b, double x) {
+
+    if (x <= 0.0)
+        return 0.0;
+    if (x >= 1.0)
+        return 1.0;
+
+    double front = exp(lgamma(a + b) - lgamma(a) - lgamma(b) + a * log(x) + b * log(1.0 - x));
+
+    if (x < (a + 1) / (a + b + 2))
+        return front * betaFraction(a, b, x) / a;
+    else
+        return 1.0 - front * betaFraction(b, a, 1.0 - x) / b;
+}
@@ -0,0 +1,35 @@
+/*
+ * Optional knobs of the lists, read from the environment
+ *
+ * The positional arguments of a list are its workload; everything that only switches a
+ * feature on or tunes it (compaction, the write-ahead log, the open loop, the scheduler,
+ * fingers) comes from an environment variable instead, as SAMPLE_CLOCK and GIT_REVISION
+ * already do. A variable that is unset or empty leaves the default in place:
+ *
+ *     FINGER_MODE=1 LOCALITY=0.9 ./rw_linked_list 300 1000 10000 4 0.90 0.05 0.05
+ *
+ * */
+#ifndef ENV_OPTIONS_H
+#define ENV_OPTIONS_H
+
+#include <stdlib.h>
+
+//Integer knob, or the default when the variable is not set
+static inline int envInt(char *name, int defaultValue) {
+    char *value_p = getenv(name);
+
+    if (value_p == NULL || *value_p == '\0')
+        return defaultValue;
+    return (int) strtol(value_p, (char**) NULL, 10);
+}
+
+//Floating point knob, or the default when the variable is not set
+static inline double envDouble(char *name, double defaultValue) {
+    char *value_p = getenv(name);
+
+    if (value_p == NULL || *value_p == '\0')
+        return defaultValue;
+    return atof(value_p);
+}
+
+#endif
@@ -2,12 +2,32 @@
 # ----------------------------------------------------------------------------
 
 # ----- Compile the source codes -----------------------------------------
-gcc -g -Wall -pthread -o serial_linked_list serial_linked_list.c -lm
-gcc -g -Wall -pthread -o mutex_linked_list mutex_linked_list.c -lm
-gcc -g -Wall -pthread -o rw_linked_list rw_linked_list.c -lm
+# Extra compiler flags can be passed in CFLAGS, e.g. CFLAGS=-DLOCK_PROFILE sh execute.sh
+gcc -g -Wall $CFLAGS -pthread -o serial_linked_list serial_linked_list.c -lm
+gcc -g -Wall $CFLAGS -pthread -o mutex_linked_list mutex_linked_list.c -lm
+gcc -g -Wall $CFLAGS -pthread -o rw_linked_list rw_linked_list.c -lm
+gcc -g -Wall $CFLAGS -o compact_linked_list compact_linked_list.c -lm
+gcc -g -Wall $CFLAGS -o generic_linked_list generic_linked_list.c -lm
+gcc -g -Wall $CFLAGS -o batch_linked_list batch_linked_list.c -lm
+gcc -g -Wall $CFLAGS -pthread -o snapshot_linked_list snapshot_linked_list.c -lm
+gcc -g -Wall $CFLAGS -pthread -o adaptive_linked_list adaptive_linked_list.c -lm
+gcc -g -Wall $CFLAGS -pthread -o hash_linked_list hash_linked_list.c -lm
+gcc -g -Wall $CFLAGS -pthread -o pq_linked_list pq_linked_list.c -lm
+gcc -g -Wall $CFLAGS -pthread -o bitmap_linked_list bitmap_linked_list.c -lm
+gcc -g -Wall $CFLAGS -o shm_linked_list shm_linked_list.c -lm -lpthread -lrt
+gcc -g -Wall $CFLAGS -o set_server set_server.c -lpthread
+gcc -g -Wall $CFLAGS -o set_client set_client.c -lpthread
+gcc -g -Wall -o compare_results compare_results.c -lm
 
 echo "Compilation Finished."
 
+# ----- Revision the results are recorded against in benchmarks.tsv -------
+GIT_REVISION=$(git rev-parse --short HEAD 2>/dev/null || echo unknown)
+if [ -n "$(git status --porcelain --untracked-files=no 2>/dev/null)" ]; then
+	GIT_REVISION="$GIT_REVISION-dirty"
+fi
+export GIT_REVISION
+
 # ----- Run Serial Linked list -----------------------------------------
 echo "...Running Serial List..."
 ./serial_linked_list  300 1000 10000 0.99 0.005 0.005
@@ -53,4 +73,195 @@ echo "Case 2 Finished..."
 ./rw_linked_list  400 1000 10000 8 0.500 0.25 0.25
 echo "Case 3 Finished..."
 
+# ----- Run Snapshot set on the read mostly case of the lists above -----------
+echo "...Running Snapshot Set..."
+./snapshot_linked_list  300 1000 10000 1 0.99 0.005 0.005
+./snapshot_linked_list  300 1000 10000 2 0.99 0.005 0.005
+./snapshot_linked_list  300 1000 10000 4 0.99 0.005 0.005
+./snapshot_linked_list  300 1000 10000 8 0.99 0.005 0.005
+echo "Case 1 Finished..."
+
+# ----- Run Adaptive list on the cases of the lists above ----------------------
+# Mode changes and their triggers are appended to adaptive_modes.log
+echo "...Running Adaptive List..."
+./adaptive_linked_list  300 1000 10000 4 0.99 0.005 0.005
+./adaptive_linked_list  300 1000 10000 4 0.90 0.05 0.05
+./adaptive_linked_list  300 1000 10000 4 0.500 0.25 0.25
+# Read mostly and batch ingest mixes alternating every 5000 operations per thread
+./adaptive_linked_list  100 1000 100000 4 0.99 0.005 0.005 0.500 0.25 0.25 5000
+echo "Adaptive Finished..."
+
+# ----- Run Split-ordered hash set on the cases of the lists above ----------
+echo "...Running Hash Set..."
+./hash_linked_list  300 1000 10000 4 0.99 0.005 0.005
+./hash_linked_list  300 1000 10000 4 0.90 0.05 0.05
+./hash_linked_list  300 1000 10000 4 0.500 0.25 0.25
+# Last argument : grow the set from n to this many items while the mix runs
+./hash_linked_list  3 1000 10000 4 0.90 0.05 0.05 10000000
+echo "Hash Set Finished..."
+
+# ----- Run the atomic bitmap set, the upper bound of the lists above ---------
+# Last argument : key range, above 16777216 keys the set falls back to the read write lock list
+echo "...Running Bitmap Set..."
+./bitmap_linked_list  300 1000 10000 4 0.99 0.005 0.005
+./bitmap_linked_list  300 1000 10000 4 0.90 0.05 0.05
+./bitmap_linked_list  300 1000 10000 4 0.500 0.25 0.25
+./bitmap_linked_list  300 1000 10000 8 0.500 0.25 0.25
+./bitmap_linked_list  30 1000000 1000000 4 0.90 0.05 0.05 16777216
+echo "Bitmap Set Finished..."
+
+# ----- Run the priority queue with each PopMin ------------------------------
+# Arguments after noOfThreads : mInsert mPop popMode (0 = locked, 1 = exact lock free, 2 = spray)
+# Timed on the wall clock : threads blocked on the lock use no CPU time while lock free retries do
+echo "...Running Priority Queue..."
+for threads in 1 2 4 8 16 32 64; do
+	for popMode in 0 1 2; do
+		SAMPLE_CLOCK=wall ./pq_linked_list  300 1000 10000 $threads 0.500 0.500 $popMode
+	done
+done
+echo "Priority Queue Finished..."
+
+# ----- Sweep the offered load of the threaded lists (open loop) --------------
+# Environment : OFFERED_RATE (ops/sec) ARRIVAL_MODE (0 = constant, 1 = poisson)
+# Each run appends a point of the latency versus throughput curve to latency_curve.tsv
+echo "...Running Open Loop Sweep..."
+for rate in 25000 50000 100000 200000 400000 800000 1600000 3200000; do
+	OFFERED_RATE=$rate ARRIVAL_MODE=1 ./mutex_linked_list  30 1000 10000 4 0.90 0.05 0.05
+	OFFERED_RATE=$rate ARRIVAL_MODE=1 ./rw_linked_list  30 1000 10000 4 0.90 0.05 0.05
+done
+# Saturation point of this revision : the highest offered rate still sustained (achieved >= 95% of offered)
+awk -F'\t' -v revision="$GIT_REVISION" '$1 == revision {
+		key = $2 " threads=" $3 " n=" $4 " m=" $5 " mix=" $6 "/" $7 "/" $8 " " $9 }
+	$1 == revision && $11 >= 0.95 * $10 && $10 > saturation[key] { saturation[key] = $10 }
+	END { for (key in saturation) printf "Saturation %s = %.0f ops/sec\n", key, saturation[key] }' latency_curve.tsv
+echo "Open Loop Finished..."
+
+# ----- Compare the operation schedules of the threaded lists -----------------
+# Environment : SCHEDULE_MODE (0 = per thread quotas, 1 = static chunks, 2 = work stealing)
+# The completion skew between the first and the last thread is written to results.txt
+echo "...Running Operation Scheduler..."
+for mode in 0 1 2; do
+	SCHEDULE_MODE=$mode ./mutex_linked_list  300 1000 10000 4 0.500 0.25 0.25
+	SCHEDULE_MODE=$mode ./rw_linked_list  300 1000 10000 4 0.500 0.25 0.25
+	SCHEDULE_MODE=$mode ./rw_linked_list  300 1000 10000 8 0.500 0.25 0.25
+done
+echo "Scheduler Finished..."
+
+# ----- Run the pointer lists with and without fingers ------------------------
+# Environment : FINGER_MODE (0 = off, 1 = on) LOCALITY (fraction of keys just above the thread's previous key)
+# The hops per operation are written to results.txt
+echo "...Running Fingers..."
+for locality in 0 0.9; do
+	for finger in 0 1; do
+		FINGER_MODE=$finger LOCALITY=$locality ./serial_linked_list  300 1000 10000 0.90 0.05 0.05
+		FINGER_MODE=$finger LOCALITY=$locality ./mutex_linked_list  300 1000 10000 4 0.90 0.05 0.05
+		FINGER_MODE=$finger LOCALITY=$locality ./rw_linked_list  300 1000 10000 4 0.90 0.05 0.05
+	done
+done
+echo "Fingers Finished..."
+
+# ----- Run Compact Linked list against the Serial list -----------------------
+# Arguments after mDelete : layout (0 = sorted, 1 = shuffled) prefetchMode (0 = off, 1 = links)
+# serial vs shuffled is the node size, shuffled vs sorted the layout, prefetch on vs off the prefetch
+echo "...Running Compact List..."
+for size in "300 1000 10000" "100 100000 1000" "30 1000000 100"; do
+	./serial_linked_list  $size 0.99 0.005 0.005
+	for layout in 0 1; do
+		for prefetchMode in 0 1; do
+			./compact_linked_list  $size 0.99 0.005 0.005 $layout $prefetchMode
+		done
+	done
+done
+echo "Compact Finished..."
+
+# ----- Run the generic list with each key type ------------------------------
+# Last argument : 0 = int, 1 = 64-bit, 2 = 64-bit with a 16 byte payload, 3 = string keys
+echo "...Running Generic Keys..."
+for keyType in 0 1 2 3; do
+	./generic_linked_list  300 1000 10000 0.99 0.005 0.005 $keyType
+	./generic_linked_list  300 1000 10000 0.500 0.25 0.25 $keyType
+done
+echo "Generic Keys Finished..."
+
+# ----- Run batched Member lookups against sequential Member calls ------------
+# Last argument : number of traversals interleaved on one thread
+echo "...Running Batched Member..."
+./batch_linked_list  30 1000000 50 4
+./batch_linked_list  30 1000000 50 16
+./batch_linked_list  30 1000000 50 64
+echo "Batched Member Finished..."
+
+# ----- Run the concurrent lists with compaction ------------------------------
+# Environment : COMPACT_MODE (1 = compact once before the operations, 2 = background compaction)
+echo "...Running Compaction..."
+COMPACT_MODE=1 ./mutex_linked_list  300 20000 2000 4 0.500 0.25 0.25
+COMPACT_MODE=2 ./mutex_linked_list  300 20000 2000 4 0.500 0.25 0.25
+COMPACT_MODE=1 ./rw_linked_list  300 20000 2000 4 0.500 0.25 0.25
+COMPACT_MODE=2 ./rw_linked_list  300 20000 2000 4 0.500 0.25 0.25
+echo "Compaction Finished..."
+
+# ----- Run Shared Memory Linked list with processes instead of threads -------
+# Last argument : 0 = mutex for entire list, 1 = read write lock
+echo "...Running Shared Memory List..."
+./shm_linked_list  300 1000 10000 1 0.99 0.005 0.005 0
+./shm_linked_list  300 1000 10000 2 0.99 0.005 0.005 0
+./shm_linked_list  300 1000 10000 4 0.99 0.005 0.005 0
+./shm_linked_list  300 1000 10000 8 0.99 0.005 0.005 0
+echo "Case 1 Finished..."
+./shm_linked_list  300 1000 10000 1 0.90 0.05 0.05 0
+./shm_linked_list  300 1000 10000 2 0.90 0.05 0.05 0
+./shm_linked_list  300 1000 10000 4 0.90 0.05 0.05 0
+./shm_linked_list  300 1000 10000 8 0.90 0.05 0.05 0
+echo "Case 2 Finished..."
+./shm_linked_list  300 1000 10000 1 0.500 0.25 0.25 0
+./shm_linked_list  300 1000 10000 2 0.500 0.25 0.25 0
+./shm_linked_list  300 1000 10000 4 0.500 0.25 0.25 0
+./shm_linked_list  300 1000 10000 8 0.500 0.25 0.25 0
+echo "Case 3 Finished..."
+./shm_linked_list  300 1000 10000 1 0.99 0.005 0.005 1
+./shm_linked_list  300 1000 10000 2 0.99 0.005 0.005 1
+./shm_linked_list  300 1000 10000 4 0.99 0.005 0.005 1
+./shm_linked_list  300 1000 10000 8 0.99 0.005 0.005 1
+echo "Case 1 Finished..."
+./shm_linked_list  300 1000 10000 1 0.90 0.05 0.05 1
+./shm_linked_list  300 1000 10000 2 0.90 0.05 0.05 1
+./shm_linked_list  300 1000 10000 4 0.90 0.05 0.05 1
+./shm_linked_list  300 1000 10000 8 0.90 0.05 0.05 1
+echo "Case 2 Finished..."
+./shm_linked_list  300 1000 10000 1 0.500 0.25 0.25 1
+./shm_linked_list  300 1000 10000 2 0.500 0.25 0.25 1
+./shm_linked_list  300 1000 10000 4 0.500 0.25 0.25 1
+./shm_linked_list  300 1000 10000 8 0.500 0.25 0.25 1
+echo "Case 3 Finished..."
+
+# ----- Run the Set Server with its load generator ----------------------------
+# Client arguments : socketPath noOfConnections m mMember mInsert mDelete pipelineDepth [rate]
+echo "...Running Set Server..."
+./set_server /tmp/linked_list_set.sock 4 1000 &
+SERVER_PID=$!
+sleep 1
+./set_client /tmp/linked_list_set.sock 4 100000 0.99 0.005 0.005 1
+./set_client /tmp/linked_list_set.sock 4 100000 0.99 0.005 0.005 16
+./set_client /tmp/linked_list_set.sock 4 100000 0.90 0.05 0.05 1
+./set_client /tmp/linked_list_set.sock 4 100000 0.90 0.05 0.05 16
+./set_client /tmp/linked_list_set.sock 4 100000 0.500 0.25 0.25 1
+./set_client /tmp/linked_list_set.sock 4 100000 0.500 0.25 0.25 16
+./set_client /tmp/linked_list_set.sock 4 100000 0.90 0.05 0.05 1 10000
+./set_client /tmp/linked_list_set.sock 4 100000 0.90 0.05 0.05 1 50000
+kill -INT $SERVER_PID
+wait $SERVER_PID
+echo "Set Server Finished..."
 
+# ----- Run Read Write Lock Linked list with the write-ahead log -------------
+# Environment : WAL_MODE (1 = asynchronous, 2 = synchronous) COMMIT_INTERVAL (us)
+# Compare with the 4 thread results of the Read Write Lock List above
+echo "...Running Durable Read Write Lock List..."
+WAL_MODE=1 COMMIT_INTERVAL=1000 ./rw_linked_list  300 1000 10000 4 0.99 0.005 0.005
+WAL_MODE=2 COMMIT_INTERVAL=1000 ./rw_linked_list  300 1000 10000 4 0.99 0.005 0.005
+echo "Case 1 Finished..."
+WAL_MODE=1 COMMIT_INTERVAL=1000 ./rw_linked_list  300 1000 10000 4 0.90 0.05 0.05
+WAL_MODE=2 COMMIT_INTERVAL=1000 ./rw_linked_list  300 1000 10000 4 0.90 0.05 0.05
+echo "Case 2 Finished..."
+WAL_MODE=1 COMMIT_INTERVAL=1000 ./rw_linked_list  300 1000 10000 4 0.500 0.25 0.25
+WAL_MODE=2 COMMIT_INTERVAL=1000 ./rw_linked_list  300 1000 10000 4 0.500 0.25 0.25
+echo "Case 3 Finished..."
@@ -0,0 +1,161 @@
+/*
+ * Per thread fingers (search hints) for the pointer based lists
+ *
+ * Every operation of a worker thread leaves its finger at the last node before the key it
+ * looked for. When the next key of the thread is greater than the finger's key, Member,
+ * Insert and Delete start the traversal from the finger instead of the head, which skips
+ * most of the list for sequential and hotspot traffic.
+ *
+ * A finger has to point to a live node. Delete calls fingerRelease() on the node it is
+ * about to free, which drops every finger on it, and a compaction, which moves every node,
+ * calls fingerReleaseAll(). Both run under the list's exclusive lock and the fingers are
+ * only used and moved under the list's lock (shared or exclusive), so a finger is never
+ * followed once its node is gone. Only the worker threads use fingers, the main thread's
+ * populate and log replay always start from the head.
+ *
+ * The hops per operation of the worker threads are counted with and without fingers.
+ *
+ * MAX_THREADS and struct list_node_s have to be defined before this file is included.
+ *
+ * */
+#ifndef FINGER_H
+#define FINGER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+//Finger modes, given after the optional arguments of each list
+#define FINGER_OFF 0
+#define FINGER_ON 1
+
+//Local keys are at most this far above the thread's previous key
+#define LOCALITY_SPAN 64
+
+static int fingerMode = FINGER_OFF;
+
+//Fraction of the operations whose key is close above the thread's previous key
+static double locality = 0.0;
+
+//Finger and traversal statistics of one thread
+struct finger_s {
+    struct list_node_s *node;
+    unsigned long epoch;
+    int lastKey;
+    unsigned int seed;
+    unsigned long ops;
+    unsigned long hops;
+    unsigned long hits;
+} __attribute__((aligned(64)));
+
+static struct finger_s fingers[MAX_THREADS];
+static __thread struct finger_s *finger = NULL;
+static int fingerThreads = 0;
+
+//Bumped by a compaction, a finger taken before it is stale
+static unsigned long fingerEpoch = 0;
+
+//Totals of the run
+static unsigned long fingerOps = 0;
+static unsigned long fingerHops = 0;
+static unsigned long fingerHits = 0;
+
+//Start a sample, no thread holds a finger
+static inline void fingerBegin(int noOfThreads) {
+    int i;
+
+    fingerThreads = noOfThreads;
+    for (i = 0; i < noOfThreads; i++) {
+        fingers[i].node = NULL;
+        fingers[i].lastKey = 0;
+        fingers[i].seed = (unsigned int) time(NULL) ^ (i << 16);
+        fingers[i].ops = 0;
+        fingers[i].hops = 0;
+        fingers[i].hits = 0;
+    }
+}
+
+static inline void fingerThreadStart(int id) {
+    finger = &fingers[id];
+}
+
+//Key of the thread's next operation, drawn with rand() unless the workload has locality
+static inline int fingerKey(int keyRange) {
+    int key;
+
+    if (locality <= 0 || finger == NULL)
+        return rand() % keyRange;
+
+    if ((double) rand_r(&finger->seed) / ((double) RAND_MAX + 1.0) < locality)
+        key = (finger->lastKey + 1 + rand_r(&finger->seed) % LOCALITY_SPAN) % keyRange;
+    else
+        key = rand_r(&finger->seed) % keyRange;
+    finger->lastKey = key;
+    return key;
+}
+
+//Node to start the traversal for value from, NULL to start from the head
+static inline struct list_node_s *fingerStart(int value) {
+    struct list_node_s *node_p;
+
+    if (finger == NULL || fingerMode == FINGER_OFF)
+        return NULL;
+
+    node_p = finger->node;
+    if (node_p == NULL || finger->epoch != fingerEpoch || node_p->data >= value)
+        return NULL;
+    finger->hits++;
+    return node_p;
+}
+
+//End an operation of hops node visits, leaving the finger at node_p (last node before the key)
+static inline void fingerDone(struct list_node_s *node_p, long hops) {
+    if (finger == NULL)
+        return;
+
+    finger->ops++;
+    finger->hops += hops;
+    finger->node = node_p;
+    finger->epoch = fingerEpoch;
+}
+
+//Drop the fingers on a node which is about to be freed, called under the exclusive lock
+static inline void fingerRelease(struct list_node_s *node_p) {
+    int i;
+
+    if (fingerMode == FINGER_OFF)
+        return;
+    for (i = 0; i < fingerThreads; i++)
+        if (fingers[i].node == node_p)
+            fingers[i].node = NULL;
+}
+
+//Drop every finger, called under the exclusive lock when the nodes are moved
+static inline void fingerReleaseAll() {
+    fingerEpoch++;
+}
+
+//Collect the traversal statistics of a sample
+static inline void fingerEnd() {
+    int i;
+
+    for (i = 0; i < fingerThreads; i++) {
+        fingerOps += fingers[i].ops;
+        fingerHops += fingers[i].hops;
+        fingerHits += fingers[i].hits;
+    }
+}
+
+static inline void writeFingerStats(FILE *f) {
+    if (fingerOps == 0)
+        return;
+
+    fprintf(f,"Fingers = %s, locality = %.2f (keys within %d above the previous one)\n",
+            fingerMode == FINGER_ON ? "on" : "off", locality, LOCALITY_SPAN);
+    fprintf(f,"Hops per Operation = %f", (double) fingerHops / fingerOps);
+    if (fingerMode == FINGER_ON)
+        fprintf(f,", traversals started from the finger = %.1f%%", 100.0 * fingerHits / fingerOps);
+    fprintf(f,"\n");
+}
+
+#endif
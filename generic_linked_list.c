@@ -0,0 +1,354 @@
+/*
+ * Sequential Linked List with generic keys and payloads (see generic_list.h)
+ *
+ * keyType selects the instantiation the operations run on :
+ *   0 - int keys, the list of serial_linked_list.c (default)
+ *   1 - 64-bit keys
+ *   2 - 64-bit keys with a 16 byte payload
+ *   3 - 16 character string keys
+ * The 64-bit and string keys are made from the random number by a 64-bit mix, so they are
+ * spread over the whole key space like real IDs while Member and Delete still hit the
+ * populated keys as often as with int keys.
+ *
+ * Compile : gcc -g -Wall -o generic_linked_list generic_linked_list.c -lm
+ * Run : ./generic_linked_list noOfSamples n m mMember mInsert mDelete [keyType]
+ *
+ * */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#include "memory_stats.h"
+#include "sample_stats.h"
+#include "generic_list.h"
+
+#define MAX_RANDOM 65535
+
+//Key types
+#define KEY_INT 0
+#define KEY_U64 1
+#define KEY_U64_PAYLOAD 2
+#define KEY_STRING 3
+
+// Number of samples
+int noOfSamples = 0;
+
+// Number of nodes in the linked list
+int n = 0;
+
+// Keys are made from random numbers in [0, keyRange), widened beyond MAX_RANDOM for large n
+int keyRange = MAX_RANDOM;
+
+// Number of random operations in the linked list
+int m = 0;
+
+// Fractions of each operation
+float mInsert, mDelete, mMember;
+
+// Key type of the list
+int keyType = KEY_INT;
+
+char *keyTypeNames[] = {"int", "u64", "u64-payload", "string"};
+
+// Node size of the list
+size_t nodeSize = 0;
+
+//Payload kept with every 64-bit key
+struct payload_s {
+    uint64_t words[2];
+};
+
+//String key, 16 hexadecimal digits without a terminator so it sorts like the number
+struct string_key_s {
+    char text[16];
+};
+
+#define STRING_LESS(a, b) (memcmp((a).text, (b).text, sizeof((a).text)) < 0)
+#define STRING_EQUAL(a, b) (memcmp((a).text, (b).text, sizeof((a).text)) == 0)
+
+DEFINE_LIST(intList, int, ARITHMETIC_LESS, ARITHMETIC_EQUAL)
+DEFINE_LIST(u64List, uint64_t, ARITHMETIC_LESS, ARITHMETIC_EQUAL)
+DEFINE_MAP(payloadList, uint64_t, struct payload_s, ARITHMETIC_LESS, ARITHMETIC_EQUAL)
+DEFINE_LIST(stringList, struct string_key_s, STRING_LESS, STRING_EQUAL)
+
+//Spread a random number over 64 bits (splitmix64 finalizer, a bijection)
+static inline uint64_t mixKey(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+static inline int intKey(int random) {
+    return random;
+}
+
+static inline uint64_t u64Key(int random) {
+    return mixKey(random);
+}
+
+static inline struct string_key_s stringKey(int random) {
+    static const char digits[] = "0123456789abcdef";
+    struct string_key_s key;
+    uint64_t x = mixKey(random);
+    int i;
+
+    for (i = 15; i >= 0; i--, x >>= 4)
+        key.text[i] = digits[x & 0xf];
+    return key;
+}
+
+static inline struct list_no_value_s noValue(int random) {
+    return NO_VALUE;
+}
+
+static inline struct payload_s payloadValue(int random) {
+    struct payload_s value = {{(uint64_t) random, (uint64_t) random * 2}};
+    return value;
+}
+
+//Benchmark of one instantiation : the sample loop of serial_linked_list.c on its list
+#define DEFINE_DRIVER(name, KEY_LESS, makeKey, makeValue)                                 \
+                                                                                           \
+static int name##_compareNodes(const void *a, const void *b) {                            \
+    struct name##_node_s *x = *(struct name##_node_s * const *) a;                         \
+    struct name##_node_s *y = *(struct name##_node_s * const *) b;                         \
+    return KEY_LESS(y->key, x->key) - KEY_LESS(x->key, y->key);                           \
+}                                                                                          \
+                                                                                           \
+/* Linked list population function, linked in one pass after sorting the keys */          \
+static void name##_populate(int n, struct name##_node_s **head_pp) {                      \
+    int num, i;                                                                            \
+    char *used = calloc(keyRange, sizeof(char));                                           \
+    struct name##_node_s **nodes = malloc(sizeof(struct name##_node_s *) * n);             \
+                                                                                           \
+    for (i = 0; i < n; ) {                                                                 \
+        num = rand() % keyRange;                                                           \
+        if (used[num])                                                                     \
+            continue;                                                                      \
+        used[num] = 1;                                                                     \
+        nodes[i] = malloc(sizeof(struct name##_node_s));                                   \
+        nodes[i]->key = makeKey(num);                                                      \
+        nodes[i]->value = makeValue(num);                                                  \
+        i++;                                                                               \
+    }                                                                                      \
+                                                                                           \
+    qsort(nodes, n, sizeof(struct name##_node_s *), name##_compareNodes);                  \
+    for (i = 0; i < n - 1; i++)                                                            \
+        nodes[i]->next = nodes[i + 1];                                                     \
+    nodes[n - 1]->next = NULL;                                                             \
+    *head_pp = nodes[0];                                                                   \
+                                                                                           \
+    free(nodes);                                                                           \
+    free(used);                                                                            \
+}                                                                                          \
+                                                                                           \
+/* Record the memory footprint of the list at the end of a sample */                       \
+static void name##_measureMemory(struct name##_node_s *head_p) {                           \
+    struct name##_node_s *curr_p;                                                          \
+    long live = 0;                                                                         \
+    double allocated = 0.0;                                                                \
+                                                                                           \
+    for (curr_p = head_p; curr_p != NULL; curr_p = curr_p->next) {                         \
+        live++;                                                                            \
+        allocated += allocatedSize(curr_p);                                                \
+    }                                                                                      \
+    recordMemory(live, (double) live * sizeof(struct name##_node_s), allocated, 0.0);      \
+}                                                                                          \
+                                                                                           \
+/* Run one sample of m random operations, returns its time */                              \
+static double name##_runSample() {                                                         \
+    struct name##_node_s *head_p = NULL;                                                   \
+    clock_t startTime, endTime;                                                            \
+                                                                                           \
+    int totalExecuted = 0;                                                                 \
+    int memberExecuted = 0;                                                                \
+    int insertExecuted = 0;                                                                \
+    int deleteExecuted = 0;                                                                \
+                                                                                           \
+    float noOfInsert = mInsert * m;                                                        \
+    float noOfDelete = mDelete * m;                                                        \
+    float noOfMember = mMember * m;                                                        \
+                                                                                           \
+    nodeSize = sizeof(struct name##_node_s);                                               \
+    name##_populate(n, &head_p);                                                           \
+                                                                                           \
+    startTime = clock();                                                                   \
+    while (totalExecuted < m) {                                                            \
+        int randomNumber = rand() % keyRange;                                              \
+        int randomOperation = rand() % 3;                                                  \
+                                                                                           \
+        if (randomOperation == 0 && memberExecuted < noOfMember) {                         \
+            name##_Member(makeKey(randomNumber), head_p);                                  \
+            memberExecuted++;                                                              \
+        }                                                                                  \
+        else if (randomOperation == 1 && insertExecuted < noOfInsert) {                    \
+            name##_Insert(makeKey(randomNumber), makeValue(randomNumber), &head_p);        \
+            insertExecuted++;                                                              \
+        }                                                                                  \
+        else if (randomOperation == 2 && deleteExecuted < noOfDelete) {                    \
+            name##_Delete(makeKey(randomNumber), &head_p);                                 \
+            deleteExecuted++;                                                              \
+        }                                                                                  \
+        totalExecuted = insertExecuted + memberExecuted + deleteExecuted;                  \
+    }                                                                                      \
+    endTime = clock();                                                                     \
+                                                                                           \
+    name##_measureMemory(head_p);                                                          \
+    name##_destroy(&head_p);                                                               \
+    return calcTime(startTime, endTime);                                                   \
+}
+
+void validateInput(int argc, char *argv[]);
+
+double calcTime(clock_t startTime, clock_t endTime);
+
+void writeOutput(double mean, double std) ;
+
+DEFINE_DRIVER(intList, ARITHMETIC_LESS, intKey, noValue)
+DEFINE_DRIVER(u64List, ARITHMETIC_LESS, u64Key, noValue)
+DEFINE_DRIVER(payloadList, ARITHMETIC_LESS, u64Key, payloadValue)
+DEFINE_DRIVER(stringList, STRING_LESS, stringKey, noValue)
+
+int main(int argc, char *argv[]) {
+
+	//Retrieve and validate inputs
+	validateInput(argc, argv);
+
+	int sampleNumber = 0;
+
+	//Time spend for a particular sample
+	double sampleTime = 0;
+
+	//Mean of times of all the samples
+	double mean = 0;
+
+	//Standard deviation of all the samples
+	double std = 0;
+
+	//Wall time at which sampling started, used for the sampling time cap
+	time_t samplingStart = time(NULL);
+
+    //Random seed for random values
+	srand(time(NULL));
+
+	for(sampleNumber = 0; sampleNumber < noOfSamples; sampleNumber++){
+
+		resetPeakRss();
+
+		//The instantiation is chosen once per sample, the operations call it directly
+		if (keyType == KEY_INT)
+			sampleTime = intList_runSample();
+		else if (keyType == KEY_U64)
+			sampleTime = u64List_runSample();
+		else if (keyType == KEY_U64_PAYLOAD)
+			sampleTime = payloadList_runSample();
+		else
+			sampleTime = stringList_runSample();
+
+		addSample(sampleTime);
+
+		//Stop as soon as the confidence target is met
+		if (isConfidenceReached())
+			break;
+
+		//Stop if the sampling time cap is exceeded
+		if (difftime(time(NULL), samplingStart) > MAX_SAMPLING_TIME)
+			break;
+	}
+
+	//Calculate mean for all the samples
+	mean = runningMean;
+
+	//Calculate Standard deviation for all the samples
+	std = findStd();
+
+	writeOutput(mean, std);
+	char variant[64];
+	snprintf(variant, sizeof(variant), "generic-%s", keyTypeNames[keyType]);
+	writeRecord(variant, 1, n, m, mMember, mInsert, mDelete, mean, std);
+    return 0;
+}
+
+//Retrieve and validate the inputs
+void validateInput(int argc, char *argv[]) {
+
+    if (argc != 7 && argc != 8) {
+        printf("Enter the command with arguments noOfSamples, n, m, mMember, mInsert, mDelete and optionally keyType\n");
+        exit(0);
+    }
+
+    //Input retrieval
+	noOfSamples = (int) strtol(argv[1], (char **) NULL, 10);
+    n = (int) strtol(argv[2], (char **) NULL, 10);
+    m = (int) strtol(argv[3], (char **) NULL, 10);
+
+    mMember = (float) atof(argv[4]);
+    mInsert = (float) atof(argv[5]);
+    mDelete = (float) atof(argv[6]);
+    if (argc == 8)
+        keyType = (int) strtol(argv[7], (char **) NULL, 10);
+
+    //Input validation
+	if (noOfSamples <= 0){
+		printf("Invalid input for noOfSamples (noOfSamples > 0)\n");
+		exit(0);
+	} else if (n <= 0){
+		printf("Invalid input for n (n > 0)\n");
+		exit(0);
+	}else if (m <= 0){
+		printf("Invalid input for m (m > 0)\n");
+		exit(0);
+
+	}else if (mMember + mInsert + mDelete != 1.0){
+		printf("Invalid combination of fractions (Total = 1.0)\n");
+		exit(0);
+	}else if (keyType < KEY_INT || keyType > KEY_STRING){
+		printf("Invalid keyType (0 = int, 1 = 64-bit, 2 = 64-bit with payload, 3 = string)\n");
+		exit(0);
+	}
+
+	//Keep the list at most half full of the key range
+	if (n > MAX_RANDOM / 2)
+		keyRange = 2 * n;
+}
+
+//Calculating time between operation start and end
+double calcTime(clock_t startTime, clock_t endTime) {
+    return (double) (endTime - startTime) / CLOCKS_PER_SEC;
+}
+
+void writeOutput(double mean, double std) {
+	FILE *f = fopen("results.txt", "a");
+	if (f == NULL)
+	{
+		printf("Error occured while opening the file \n");
+		exit(1);
+	}
+
+	fprintf(f,"\n === Generic (%s keys) === \n\n", keyTypeNames[keyType]);
+	fprintf(f,"Number of Nodes = %d\n", n);
+	fprintf(f,"Number of Operations = %d\n", m);
+	fprintf(f,"Member Fraction= %.2f\n", mMember);
+	fprintf(f,"Insert Fraction = %.3f\n", mInsert);
+	fprintf(f,"Delete Fraction = %.3f\n", mDelete);
+	fprintf(f,"Node Size (bytes) = %zu\n", nodeSize);
+	fprintf(f,"Max Number of Samples = %d\n", noOfSamples);
+	fprintf(f,"Number of Samples = %d\n", acceptedSamples);
+	fprintf(f,"Rejected Outliers = %d\n", rejectedSamples);
+	fprintf(f,"Min number of samples needed = %f\n", minNoOfSamples);
+	fprintf(f,"Mean = %f\n", mean);
+	fprintf(f,"Standard Deviation = %f\n", std);
+	fprintf(f,"Throughput (ops/sec) = %f\n", mean > 0 ? m / mean : 0.0);
+	fprintf(f,"Confidence Interval (95%%) = +/- %f (%.2f%% of mean)\n", 1.96*std/sqrt(acceptedSamples), mean > 0 ? 100*1.96*std/sqrt(acceptedSamples)/mean : 0.0);
+	writeMemoryStats(f);
+	fprintf(f,"________________________________________ \n\n");
+
+	fclose(f);
+}
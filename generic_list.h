@@ -0,0 +1,130 @@
+/*
+ * Sorted linked list specialized at compile time for a key type, a payload type and a comparator
+ *
+ *     DEFINE_LIST(name, key_t, KEY_LESS, KEY_EQUAL)
+ *     DEFINE_MAP(name, key_t, value_t, KEY_LESS, KEY_EQUAL)
+ *
+ * define struct name_node_s and the static inline functions
+ *
+ *     int name_Member(key_t key, struct name_node_s *head_p)
+ *     int name_Find(key_t key, struct name_node_s *head_p, value_t *value_p)
+ *     int name_Insert(key_t key, value_t value, struct name_node_s **head_pp)
+ *     int name_Delete(key_t key, struct name_node_s **head_pp)
+ *     void name_destroy(struct name_node_s **head_pp)
+ *
+ * A list made by DEFINE_LIST keeps no payload, its value_t is the empty struct list_no_value_s
+ * and NO_VALUE is passed to Insert. KEY_LESS(a, b) and KEY_EQUAL(a, b) are macros, so the
+ * comparison is inlined into every traversal instead of being called through a pointer, and
+ * the node holds the key and the payload by value : an int list keeps the 16 byte nodes of
+ * the other lists, a 64-bit key with a 16 byte payload makes a 32 byte node.
+ *
+ * */
+#ifndef GENERIC_LIST_H
+#define GENERIC_LIST_H
+
+#include <stdlib.h>
+
+//Payload of a list without values, it takes no space in the node (a GNU C empty struct)
+struct list_no_value_s {};
+
+#define NO_VALUE ((struct list_no_value_s) {})
+
+//Comparators for the arithmetic key types
+#define ARITHMETIC_LESS(a, b) ((a) < (b))
+#define ARITHMETIC_EQUAL(a, b) ((a) == (b))
+
+#define DEFINE_LIST(name, key_t, KEY_LESS, KEY_EQUAL) \
+    DEFINE_MAP(name, key_t, struct list_no_value_s, KEY_LESS, KEY_EQUAL)
+
+#define DEFINE_MAP(name, key_t, value_t, KEY_LESS, KEY_EQUAL)                           \
+                                                                                         \
+struct name##_node_s {                                                                   \
+    struct name##_node_s *next;                                                          \
+    key_t key;                                                                           \
+    value_t value;                                                                       \
+};                                                                                       \
+                                                                                         \
+/* Linked List Membership function */                                                    \
+static inline int name##_Member(key_t key, struct name##_node_s *head_p) {              \
+    struct name##_node_s *current_p = head_p;                                            \
+                                                                                         \
+    while (current_p != NULL && KEY_LESS(current_p->key, key))                           \
+        current_p = current_p->next;                                                     \
+                                                                                         \
+    return current_p != NULL && KEY_EQUAL(current_p->key, key);                          \
+}                                                                                        \
+                                                                                         \
+/* Membership which also returns the payload of the key */                               \
+static inline int name##_Find(key_t key, struct name##_node_s *head_p, value_t *value_p) { \
+    struct name##_node_s *current_p = head_p;                                            \
+                                                                                         \
+    while (current_p != NULL && KEY_LESS(current_p->key, key))                           \
+        current_p = current_p->next;                                                     \
+                                                                                         \
+    if (current_p == NULL || !KEY_EQUAL(current_p->key, key))                            \
+        return 0;                                                                        \
+    *value_p = current_p->value;                                                         \
+    return 1;                                                                            \
+}                                                                                        \
+                                                                                         \
+/* Linked List Insertion function, an existing key keeps its payload */                 \
+static inline int name##_Insert(key_t key, value_t value, struct name##_node_s **head_pp) { \
+    struct name##_node_s *curr_p = *head_pp;                                             \
+    struct name##_node_s *pred_p = NULL;                                                 \
+    struct name##_node_s *temp_p = NULL;                                                 \
+                                                                                         \
+    while (curr_p != NULL && KEY_LESS(curr_p->key, key)) {                               \
+        pred_p = curr_p;                                                                 \
+        curr_p = curr_p->next;                                                           \
+    }                                                                                    \
+                                                                                         \
+    if (curr_p != NULL && KEY_EQUAL(curr_p->key, key))                                   \
+        return 0;                                                                        \
+                                                                                         \
+    temp_p = malloc(sizeof(struct name##_node_s));                                       \
+    temp_p->key = key;                                                                   \
+    temp_p->value = value;                                                               \
+    temp_p->next = curr_p;                                                               \
+                                                                                         \
+    if (pred_p == NULL)                                                                  \
+        *head_pp = temp_p;                                                               \
+    else                                                                                 \
+        pred_p->next = temp_p;                                                           \
+    return 1;                                                                            \
+}                                                                                        \
+                                                                                         \
+/* Linked List Deletion function */                                                      \
+static inline int name##_Delete(key_t key, struct name##_node_s **head_pp) {            \
+    struct name##_node_s *curr_p = *head_pp;                                             \
+    struct name##_node_s *pred_p = NULL;                                                 \
+                                                                                         \
+    while (curr_p != NULL && KEY_LESS(curr_p->key, key)) {                               \
+        pred_p = curr_p;                                                                 \
+        curr_p = curr_p->next;                                                           \
+    }                                                                                    \
+                                                                                         \
+    if (curr_p == NULL || !KEY_EQUAL(curr_p->key, key))                                  \
+        return 0;                                                                        \
+                                                                                         \
+    if (pred_p == NULL)                                                                  \
+        *head_pp = curr_p->next;                                                         \
+    else                                                                                 \
+        pred_p->next = curr_p->next;                                                     \
+    free(curr_p);                                                                        \
+    return 1;                                                                            \
+}                                                                                        \
+                                                                                         \
+/* Free every node of the list, leaving it empty */                                      \
+static inline void name##_destroy(struct name##_node_s **head_pp) {                     \
+    struct name##_node_s *curr_p = *head_pp;                                             \
+    struct name##_node_s *next_p;                                                        \
+                                                                                         \
+    while (curr_p != NULL) {                                                             \
+        next_p = curr_p->next;                                                           \
+        free(curr_p);                                                                    \
+        curr_p = next_p;                                                                 \
+    }                                                                                    \
+    *head_pp = NULL;                                                                     \
+}
+
+#endif
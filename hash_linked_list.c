@@ -0,0 +1,773 @@
+/*
+ * Lock free hash set on a single split-ordered linked list (Shalev and Shavit)
+ *
+ * All the items are kept in one sorted list, ordered by their split order key : the
+ * bit reversed hash of the value. The bucket array only holds pointers to sentinel
+ * nodes inside that list, bucket b starting at the sentinel with the reversed key of b,
+ * so doubling the number of buckets never moves an item : a new bucket is initialized
+ * lazily, the first time it is used, by inserting its sentinel after the sentinel of
+ * its parent bucket (b with its highest set bit cleared). The bucket array is made of
+ * segments which are allocated on first use, so it grows without being copied.
+ *
+ * The list itself is the lock free list of Harris and Michael : a node is deleted by
+ * marking the low bit of its next pointer and then unlinked with a compare and swap,
+ * by the deleting thread or by the next traversal which finds it. Unlinked nodes are
+ * retired, not freed, as a concurrent traversal may still hold them, and are freed at
+ * the end of the sample.
+ *
+ * With growTo the set grows from n to growTo items while the threads run the mixed
+ * workload, and the workload throughput is reported for every tenfold growth.
+ *
+ * Compile : gcc -g -Wall -o hash_linked_list hash_linked_list.c -lm -pthread
+ * Run : ./hash_linked_list noOfSamples n m noOfThreads mMember mInsert mDelete [growTo]
+ *
+ * */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "memory_stats.h"
+#include "sample_clock.h"
+#include "sample_stats.h"
+
+#define MAX_THREADS 1024
+#define MAX_RANDOM 65535
+
+//Buckets per segment of the bucket array, and the number of segments
+#define SEGMENT_SIZE 1024
+#define MAX_SEGMENTS 16384
+#define MAX_BUCKETS ((unsigned long) SEGMENT_SIZE * MAX_SEGMENTS)
+
+//Buckets of an empty set, and the mean items per bucket above which they are doubled
+#define INITIAL_BUCKETS 2
+#define LOAD_FACTOR 2
+
+//Tenfold growth steps reported by the resize benchmark
+#define MAX_DECADES 16
+
+// Number of samples
+int noOfSamples = 0;
+
+// Number of nodes in the linked list
+int n = 0;
+
+// Number of random operations in the linked list
+int m = 0;
+
+// Number of threads to execute
+int noOfThreads = 0;
+
+// Fractions of each operation
+float mInsert = 0.0, mDelete = 0.0, mMember = 0.0;
+
+// Total number of each operation
+int noOfInsert = 0, noOfDelete = 0, noOfMember = 0;
+
+// Items the set grows to while the workload runs, 0 to run m operations on n items
+int growTo = 0;
+
+// Values are drawn from [0, keyRange)
+int keyRange = MAX_RANDOM;
+
+//Node definition, sentinels have even keys and regular nodes odd keys
+struct list_node_s {
+    unsigned long key;
+    int data;
+    struct list_node_s *next;
+    struct list_node_s *retiredNext;
+};
+
+//Sentinel of bucket 0, the head of the list
+struct list_node_s *head = NULL;
+
+//Segments of the bucket array, allocated on first use
+struct list_node_s **segments[MAX_SEGMENTS];
+
+//Number of buckets in use and number of items in the set
+unsigned long bucketCount = INITIAL_BUCKETS;
+long itemCount = 0;
+
+//Unlinked nodes, freed at the end of the sample
+struct list_node_s *retired = NULL;
+
+//Set to stop the workload of the resize benchmark
+int stopWorkload = 0;
+
+//Operations of every thread, read while the set grows
+struct thread_count_s {
+    unsigned long ops;
+} __attribute__((aligned(64)));
+
+struct thread_count_s threadCounts[MAX_THREADS];
+
+//Statistics of the run
+long doublings = 0;
+long sentinels = 0;
+double decadeTime[MAX_DECADES];
+double decadeOps[MAX_DECADES];
+int decades = 0;
+
+int Member(int value);
+
+int Insert(int value);
+
+int Delete(int value);
+
+int listFind(struct list_node_s *start_p, unsigned long key, struct list_node_s **pred_pp, struct list_node_s **curr_pp);
+
+struct list_node_s *listInsert(struct list_node_s *start_p, struct list_node_s *node_p);
+
+int listDelete(struct list_node_s *start_p, unsigned long key);
+
+int listMember(struct list_node_s *start_p, unsigned long key);
+
+struct list_node_s *getBucket(unsigned long bucket);
+
+void setBucket(unsigned long bucket, struct list_node_s *node_p);
+
+struct list_node_s *initializeBucket(unsigned long bucket);
+
+struct list_node_s *bucketOf(unsigned int hash);
+
+unsigned int hashValue(int value);
+
+unsigned long reverseBits(unsigned long word);
+
+void retireNode(struct list_node_s *node_p);
+
+double calcTime(clock_t startTime, clock_t endTime);
+
+double wallTime();
+
+void validateInput(int argc, char *argv[]);
+
+void populate(int n);
+
+void destroy();
+
+void measureMemory();
+
+void *threadOperation(void *id);
+
+void *workloadOperation(void *id);
+
+void grow(double startWall);
+
+void writeOutput(double mean, double std);
+
+int main(int argc, char *argv[]) {
+
+    //Retrieve and validate inputs
+    validateInput(argc, argv);
+
+	int sampleNumber = 0;
+
+	//Time spend for a particular sample
+	double sampleTime = 0;
+
+	//Mean of times of all the samples
+	double mean = 0;
+
+	//Standard deviation of all the samples
+	double std = 0;
+
+	//Time keeping variables
+    clock_t startTime, endTime;
+    double startWall = 0, endWall = 0;
+
+	//Wall time at which sampling started, used for the sampling time cap
+	time_t samplingStart = time(NULL);
+
+    //Random seed for random values
+    srand(time(NULL));
+
+	for(sampleNumber = 0; sampleNumber < noOfSamples; sampleNumber++){
+
+		//Defining threads
+		pthread_t* threadHandlers;
+		threadHandlers = malloc(sizeof(pthread_t) * noOfThreads);
+
+		// Calculating the total number of each operation
+		noOfInsert = mInsert * m;
+		noOfDelete = mDelete * m;
+		noOfMember = mMember * m;
+
+		int *threadId;
+		threadId = (int *)malloc(sizeof(int) * noOfThreads);
+
+		resetPeakRss();
+
+		//Populating the set with random values
+		populate(n);
+
+		int i = 0;
+		for (i = 0; i < noOfThreads; i++)
+			threadCounts[i].ops = 0;
+		stopWorkload = 0;
+
+		//Recording time at operations start
+		startTime = clock();
+		sampleClockStart();
+		sampleClockThreads(noOfThreads);
+		startWall = wallTime();
+
+		// Thread Creation
+		for (i = 0; i < noOfThreads; i++) {
+			threadId[i] = i;
+			pthread_create(&threadHandlers[i], NULL, growTo > 0 ? workloadOperation : threadOperation, (void *) &threadId[i]);
+		}
+
+		//Growing the set under the workload
+		if (growTo > 0) {
+			grow(startWall);
+			__atomic_store_n(&stopWorkload, 1, __ATOMIC_RELAXED);
+		}
+
+		// Thread Join
+		for (i = 0; i < noOfThreads; i++) {
+			pthread_join(threadHandlers[i], NULL);
+		}
+
+		//Recording the time at operation ends
+		endTime = clock();
+		sampleClockStop();
+		endWall = wallTime();
+
+		//Deallocate the memory of this sample's set
+		measureMemory();
+		destroy();
+
+		//Deallocate the memory of this sample's thread handlers
+		free(threadHandlers);
+		free(threadId);
+
+		//The growth is timed on the wall clock, the threads share it with the growing thread
+		sampleTime = growTo > 0 ? endWall - startWall : sampleClockTime(calcTime(startTime, endTime));
+		addSample(sampleTime);
+
+		//Stop as soon as the confidence target is met
+		if (isConfidenceReached())
+			break;
+
+		//Stop if the sampling time cap is exceeded
+		if (difftime(time(NULL), samplingStart) > MAX_SAMPLING_TIME)
+			break;
+	}
+
+	//Calculate mean for all the samples
+	mean = runningMean;
+
+	//Calculate Standard deviation for all the samples
+	std = findStd();
+
+	writeOutput(mean, std);
+	char variant[64];
+	if (growTo > 0)
+		snprintf(variant, sizeof(variant), "hash-grow%d", growTo);
+	else
+		snprintf(variant, sizeof(variant), "hash");
+	writeRecord(variant, noOfThreads, n, m, mMember, mInsert, mDelete, mean, std);
+
+    return 0;
+}
+
+
+//Hash of a value, a bijection so that different values never share a key
+unsigned int hashValue(int value) {
+    unsigned int h = (unsigned int) value;
+
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h;
+}
+
+unsigned long reverseBits(unsigned long word) {
+    word = ((word >> 1) & 0x5555555555555555UL) | ((word & 0x5555555555555555UL) << 1);
+    word = ((word >> 2) & 0x3333333333333333UL) | ((word & 0x3333333333333333UL) << 2);
+    word = ((word >> 4) & 0x0f0f0f0f0f0f0f0fUL) | ((word & 0x0f0f0f0f0f0f0f0fUL) << 4);
+    return __builtin_bswap64(word);
+}
+
+//Split order keys, the low bit tells a regular node from the sentinel of a bucket
+static inline unsigned long regularKey(unsigned int hash) {
+    return reverseBits(hash) | 1;
+}
+
+static inline unsigned long sentinelKey(unsigned long bucket) {
+    return reverseBits(bucket);
+}
+
+//Marked pointers, the low bit of next is set once the node is deleted
+static inline int isMarked(struct list_node_s *node_p) {
+    return ((uintptr_t) node_p & 1) != 0;
+}
+
+static inline struct list_node_s *marked(struct list_node_s *node_p) {
+    return (struct list_node_s *) ((uintptr_t) node_p | 1);
+}
+
+static inline struct list_node_s *unmarked(struct list_node_s *node_p) {
+    return (struct list_node_s *) ((uintptr_t) node_p & ~(uintptr_t) 1);
+}
+
+//Keep an unlinked node until the end of the sample
+void retireNode(struct list_node_s *node_p) {
+    struct list_node_s *top_p = __atomic_load_n(&retired, __ATOMIC_RELAXED);
+
+    do {
+        node_p->retiredNext = top_p;
+    } while (!__atomic_compare_exchange_n(&retired, &top_p, node_p, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+// Find the first node with a key at or above key after the sentinel start_p,
+// unlinking the deleted nodes on the way. Returns 1 if its key is key
+int listFind(struct list_node_s *start_p, unsigned long key, struct list_node_s **pred_pp, struct list_node_s **curr_pp) {
+    struct list_node_s *pred_p, *curr_p, *next_p;
+
+retry:
+    pred_p = start_p;
+    curr_p = unmarked(__atomic_load_n(&pred_p->next, __ATOMIC_ACQUIRE));
+
+    while (curr_p != NULL) {
+        next_p = __atomic_load_n(&curr_p->next, __ATOMIC_ACQUIRE);
+        if (isMarked(next_p)) {
+            //Fails if pred_p was deleted or changed meanwhile, then start again
+            if (!__atomic_compare_exchange_n(&pred_p->next, &curr_p, unmarked(next_p), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+                goto retry;
+            retireNode(curr_p);
+            curr_p = unmarked(next_p);
+            continue;
+        }
+        if (curr_p->key >= key)
+            break;
+        pred_p = curr_p;
+        curr_p = next_p;
+    }
+
+    *pred_pp = pred_p;
+    *curr_pp = curr_p;
+    return curr_p != NULL && curr_p->key == key;
+}
+
+// Linked List Insertion function
+// Returns node_p once it is linked, or the node which already holds its key
+struct list_node_s *listInsert(struct list_node_s *start_p, struct list_node_s *node_p) {
+    struct list_node_s *pred_p, *curr_p;
+
+    while (1) {
+        if (listFind(start_p, node_p->key, &pred_p, &curr_p))
+            return curr_p;
+        node_p->next = curr_p;
+        if (__atomic_compare_exchange_n(&pred_p->next, &curr_p, node_p, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            return node_p;
+    }
+}
+
+// Linked List Deletion function
+// The node is marked first, which is the point at which it is deleted, then unlinked
+int listDelete(struct list_node_s *start_p, unsigned long key) {
+    struct list_node_s *pred_p, *curr_p, *next_p;
+
+    while (1) {
+        if (!listFind(start_p, key, &pred_p, &curr_p))
+            return 0;
+        next_p = __atomic_load_n(&curr_p->next, __ATOMIC_ACQUIRE);
+        if (isMarked(next_p))
+            continue;
+        if (!__atomic_compare_exchange_n(&curr_p->next, &next_p, marked(next_p), 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+            continue;
+
+        if (__atomic_compare_exchange_n(&pred_p->next, &curr_p, next_p, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+            retireNode(curr_p);
+        else
+            listFind(start_p, key, &pred_p, &curr_p);
+        return 1;
+    }
+}
+
+// Linked List Membership function, a traversal which never writes
+int listMember(struct list_node_s *start_p, unsigned long key) {
+    struct list_node_s *current_p = unmarked(__atomic_load_n(&start_p->next, __ATOMIC_ACQUIRE));
+
+    while (current_p != NULL && current_p->key < key)
+        current_p = unmarked(__atomic_load_n(&current_p->next, __ATOMIC_ACQUIRE));
+
+    if (current_p == NULL || current_p->key != key)
+        return 0;
+    else
+        return !isMarked(__atomic_load_n(&current_p->next, __ATOMIC_ACQUIRE));
+}
+
+//Sentinel of a bucket, NULL while the bucket is not initialized
+struct list_node_s *getBucket(unsigned long bucket) {
+    struct list_node_s **segment_p = __atomic_load_n(&segments[bucket / SEGMENT_SIZE], __ATOMIC_ACQUIRE);
+
+    if (segment_p == NULL)
+        return NULL;
+    return __atomic_load_n(&segment_p[bucket % SEGMENT_SIZE], __ATOMIC_ACQUIRE);
+}
+
+//Publish the sentinel of a bucket, allocating its segment if it has none yet
+void setBucket(unsigned long bucket, struct list_node_s *node_p) {
+    struct list_node_s **segment_p = __atomic_load_n(&segments[bucket / SEGMENT_SIZE], __ATOMIC_ACQUIRE);
+    struct list_node_s **expected_p = NULL;
+
+    if (segment_p == NULL) {
+        segment_p = calloc(SEGMENT_SIZE, sizeof(struct list_node_s *));
+        if (!__atomic_compare_exchange_n(&segments[bucket / SEGMENT_SIZE], &expected_p, segment_p, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            free(segment_p);
+            segment_p = expected_p;
+        }
+    }
+    __atomic_store_n(&segment_p[bucket % SEGMENT_SIZE], node_p, __ATOMIC_RELEASE);
+}
+
+//Insert the sentinel of a bucket after the sentinel of its parent bucket
+//Threads racing on the same bucket all publish the sentinel which won the insertion
+struct list_node_s *initializeBucket(unsigned long bucket) {
+    unsigned long parent = bucket & ~(1UL << (63 - __builtin_clzl(bucket)));
+    struct list_node_s *parent_p = getBucket(parent);
+    struct list_node_s *sentinel_p, *node_p;
+
+    if (parent_p == NULL)
+        parent_p = initializeBucket(parent);
+
+    node_p = malloc(sizeof(struct list_node_s));
+    node_p->key = sentinelKey(bucket);
+    node_p->data = -1;
+    node_p->retiredNext = NULL;
+
+    sentinel_p = listInsert(parent_p, node_p);
+    if (sentinel_p != node_p)
+        free(node_p);
+    else
+        __atomic_fetch_add(&sentinels, 1, __ATOMIC_RELAXED);
+    setBucket(bucket, sentinel_p);
+    return sentinel_p;
+}
+
+//Sentinel of the bucket of a hash, under the current number of buckets
+struct list_node_s *bucketOf(unsigned int hash) {
+    unsigned long bucket = hash & (__atomic_load_n(&bucketCount, __ATOMIC_ACQUIRE) - 1);
+    struct list_node_s *sentinel_p = getBucket(bucket);
+
+    if (sentinel_p == NULL)
+        sentinel_p = initializeBucket(bucket);
+    return sentinel_p;
+}
+
+// Hash set Membership function
+int Member(int value) {
+    unsigned int hash = hashValue(value);
+
+    return listMember(bucketOf(hash), regularKey(hash));
+}
+
+// Hash set Insertion function, doubles the buckets once the load factor is exceeded
+int Insert(int value) {
+    unsigned int hash = hashValue(value);
+    struct list_node_s *node_p = malloc(sizeof(struct list_node_s));
+    unsigned long buckets;
+    long items;
+
+    node_p->key = regularKey(hash);
+    node_p->data = value;
+    node_p->retiredNext = NULL;
+
+    if (listInsert(bucketOf(hash), node_p) != node_p) {
+        free(node_p);
+        return 0;
+    }
+
+    items = __atomic_add_fetch(&itemCount, 1, __ATOMIC_RELAXED);
+    buckets = __atomic_load_n(&bucketCount, __ATOMIC_RELAXED);
+    if (items > (long) (LOAD_FACTOR * buckets) && 2 * buckets <= MAX_BUCKETS
+            && __atomic_compare_exchange_n(&bucketCount, &buckets, 2 * buckets, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        __atomic_fetch_add(&doublings, 1, __ATOMIC_RELAXED);
+    return 1;
+}
+
+// Hash set Deletion function
+int Delete(int value) {
+    unsigned int hash = hashValue(value);
+
+    if (!listDelete(bucketOf(hash), regularKey(hash)))
+        return 0;
+    __atomic_sub_fetch(&itemCount, 1, __ATOMIC_RELAXED);
+    return 1;
+}
+
+//Free every node of the list, the retired nodes and the bucket array, leaving the set empty
+void destroy() {
+	struct list_node_s *curr_p = head;
+	struct list_node_s *next_p;
+	int i;
+
+	while (curr_p != NULL) {
+		next_p = unmarked(curr_p->next);
+		free(curr_p);
+		curr_p = next_p;
+	}
+	head = NULL;
+
+	for (curr_p = retired; curr_p != NULL; curr_p = next_p) {
+		next_p = curr_p->retiredNext;
+		free(curr_p);
+	}
+	retired = NULL;
+
+	for (i = 0; i < MAX_SEGMENTS; i++) {
+		free(segments[i]);
+		segments[i] = NULL;
+	}
+}
+
+//Record the memory footprint of the set at the end of a sample
+//The sentinels and the bucket array are what the set costs on top of the list
+void measureMemory() {
+	struct list_node_s *curr_p;
+	long live = 0, retiredNodes = 0;
+	double allocated = 0.0;
+	int i;
+
+	for (curr_p = head; curr_p != NULL; curr_p = unmarked(curr_p->next)) {
+		if (curr_p->key & 1)
+			live++;
+		allocated += allocatedSize(curr_p);
+	}
+	for (curr_p = retired; curr_p != NULL; curr_p = curr_p->retiredNext) {
+		retiredNodes++;
+		allocated += allocatedSize(curr_p);
+	}
+	for (i = 0; i < MAX_SEGMENTS; i++)
+		if (segments[i] != NULL)
+			allocated += allocatedSize(segments[i]);
+	recordMemory(live, (double) live * sizeof(struct list_node_s), allocated,
+			(double) retiredNodes * sizeof(struct list_node_s));
+}
+
+//Retrieve and validate the inputs
+void validateInput(int argc, char *argv[]) {
+
+
+    if (argc != 8 && argc != 9) {
+        printf("Enter the command with arguments noOfSamples, n, m, noOfThreads, mMember, mInsert, mDelete and optionally growTo\n");
+        exit(0);
+    }
+
+    //Input retrieval
+	noOfSamples = (int) strtol(argv[1], (char**) NULL, 10);
+    n = (int) strtol(argv[2], (char**) NULL, 10);
+    m = (int) strtol(argv[3], (char**) NULL, 10);
+	noOfThreads = (int) strtol(argv[4], (char**) NULL, 10);
+    mMember = (float) atof(argv[5]);
+    mInsert = (float) atof(argv[6]);
+    mDelete = (float) atof(argv[7]);
+    if (argc == 9)
+        growTo = (int) strtol(argv[8], (char**) NULL, 10);
+
+    //Input validation
+	if (noOfSamples <= 0){
+		printf("Invalid input for noOfSamples (noOfSamples > 0)\n");
+		exit(0);
+	} else if (n <= 0 || n > RAND_MAX / 2){
+		printf("Invalid input for n (0 < n <= %d)\n", RAND_MAX / 2);
+		exit(0);
+	}else if (m <= 0){
+		printf("Invalid input for m (m > 0)\n");
+		exit(0);
+
+	}else if (mMember + mInsert + mDelete != 1.0){
+		printf("Invalid combination of fractions (Total = 1.0)\n");
+		exit(0);
+	}else if (growTo != 0 && (growTo <= n || growTo > RAND_MAX / 2)){
+		printf("Invalid input for growTo (n < growTo <= %d)\n", RAND_MAX / 2);
+		exit(0);
+	}
+
+    //Input validation
+    if (noOfThreads <= 0 || noOfThreads > MAX_THREADS) {
+        printf("Invalid no. of Threads (0 < noOfThreads < %d)", MAX_THREADS);
+        exit(0);
+    }
+
+    //Half the values are in the set once it is full
+    if (2 * (growTo > n ? growTo : n) > keyRange)
+        keyRange = 2 * (growTo > n ? growTo : n);
+}
+
+// Thread Operations
+// Each thread runs its share of each operation, picked in proportion to what is left,
+// with its own random state as rand() would serialize the threads on its lock
+void *threadOperation(void *threadId) {
+    int id = *(int *)threadId;
+    unsigned int seed = (unsigned int) time(NULL) ^ (id << 16);
+
+    //Number of each operations allocated for the thread
+    int memberLeft = noOfMember / noOfThreads + (noOfMember % noOfThreads > id ? 1 : 0);
+    int insertLeft = noOfInsert / noOfThreads + (noOfInsert % noOfThreads > id ? 1 : 0);
+    int deleteLeft = noOfDelete / noOfThreads + (noOfDelete % noOfThreads > id ? 1 : 0);
+
+    sampleClockThreadStart();
+
+    while (memberLeft + insertLeft + deleteLeft > 0) {
+
+        int randomNumber = rand_r(&seed) % keyRange;
+        int randomOperation = rand_r(&seed) % (memberLeft + insertLeft + deleteLeft);
+
+        if (randomOperation < memberLeft) {
+            Member(randomNumber);
+            memberLeft--;
+        }
+        else if (randomOperation < memberLeft + insertLeft) {
+            Insert(randomNumber);
+            insertLeft--;
+        }
+        else {
+            Delete(randomNumber);
+            deleteLeft--;
+        }
+    }
+    return NULL;
+}
+
+// Thread Operations of the resize benchmark, the mix runs until the set has grown
+void *workloadOperation(void *threadId) {
+    int id = *(int *)threadId;
+    unsigned int seed = (unsigned int) time(NULL) ^ (id << 16);
+    struct thread_count_s *count_p = &threadCounts[id];
+    double operation;
+
+    sampleClockThreadStart();
+
+    while (!__atomic_load_n(&stopWorkload, __ATOMIC_RELAXED)) {
+
+        int randomNumber = rand_r(&seed) % keyRange;
+        operation = (double) rand_r(&seed) / ((double) RAND_MAX + 1.0);
+
+        if (operation < mMember)
+            Member(randomNumber);
+        else if (operation < mMember + mInsert)
+            Insert(randomNumber);
+        else
+            Delete(randomNumber);
+
+        __atomic_store_n(&count_p->ops, count_p->ops + 1, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+
+//Insert random values until the set holds growTo items, noting the time and the
+//workload operations done at every tenfold growth
+void grow(double startWall) {
+    unsigned int seed = (unsigned int) time(NULL) ^ 0x5eed;
+    long target = (long) n * 10;
+    double now, ops;
+    int decade = 0, i;
+
+    while (1) {
+        if (__atomic_load_n(&itemCount, __ATOMIC_RELAXED) >= (target < growTo ? target : growTo)) {
+            now = wallTime();
+            ops = 0;
+            for (i = 0; i < noOfThreads; i++)
+                ops += __atomic_load_n(&threadCounts[i].ops, __ATOMIC_RELAXED);
+            decadeTime[decade] += now - startWall;
+            decadeOps[decade] += ops;
+            decade++;
+            if (target >= growTo || decade == MAX_DECADES)
+                break;
+            target *= 10;
+        }
+        Insert(rand_r(&seed) % keyRange);
+    }
+    decades = decade;
+}
+
+//Wall clock time in seconds
+double wallTime() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//Hash set population function, on a new list holding only the sentinel of bucket 0
+void populate(int n){
+
+	int i;
+
+	head = malloc(sizeof(struct list_node_s));
+	head->key = sentinelKey(0);
+	head->data = -1;
+	head->next = NULL;
+	head->retiredNext = NULL;
+	setBucket(0, head);
+	bucketCount = INITIAL_BUCKETS;
+	itemCount = 0;
+
+	for(i=0; i<n; ){
+		if(Insert(rand() % keyRange) == 1)
+			i++;
+	}
+}
+
+//Calculating time between operation start and end
+double calcTime(clock_t startTime, clock_t endTime) {
+    return (double) (endTime - startTime) / CLOCKS_PER_SEC;
+}
+
+void writeOutput(double mean, double std) {
+	int samples = acceptedSamples + rejectedSamples;
+	double from = n, to, time, ops, lastTime = 0, lastOps = 0;
+	int i;
+	FILE *f = fopen("results.txt", "a");
+	if (f == NULL)
+	{
+		printf("Error occured while opening the file \n");
+		exit(1);
+	}
+
+	fprintf(f,"\n === Split-Ordered Hash Set === \n\n");
+	fprintf(f,"Number of Nodes = %d\n", n);
+	if (growTo > 0)
+		fprintf(f,"Grown to = %d while the threads run the mix\n", growTo);
+	else
+		fprintf(f,"Number of Operations = %d\n", m);
+	fprintf(f,"Member Fraction= %.2f\n", mMember);
+	fprintf(f,"Insert Fraction = %.3f\n", mInsert);
+	fprintf(f,"Delete Fraction = %.3f\n", mDelete);
+	fprintf(f,"Number of Threads = %d\n", noOfThreads);
+	fprintf(f,"Max Number of Samples = %d\n", noOfSamples);
+	fprintf(f,"Number of Samples = %d\n", acceptedSamples);
+	fprintf(f,"Rejected Outliers = %d\n", rejectedSamples);
+	fprintf(f,"Min number of samples needed = %f\n", minNoOfSamples);
+	fprintf(f,"Mean = %f\n", mean);
+	fprintf(f,"Standard Deviation = %f\n", std);
+	if (growTo == 0)
+		fprintf(f,"Throughput (ops/sec) = %f\n", mean > 0 ? m / mean : 0.0);
+	fprintf(f,"Confidence Interval (95%%) = +/- %f (%.2f%% of mean)\n", 1.96*std/sqrt(acceptedSamples), mean > 0 ? 100*1.96*std/sqrt(acceptedSamples)/mean : 0.0);
+	fprintf(f,"Bucket Doublings per Sample = %f, sentinels per sample = %f\n",
+			samples > 0 ? (double) doublings / samples : 0.0, samples > 0 ? (double) sentinels / samples : 0.0);
+
+	//Workload throughput over every tenfold growth, averaged over the samples
+	for (i = 0; i < decades; i++) {
+		to = from * 10 < growTo ? from * 10 : growTo;
+		time = decadeTime[i] / samples;
+		ops = decadeOps[i] / samples;
+		fprintf(f,"Growing %.0f -> %.0f : %f sec, workload throughput (ops/sec) = %f\n",
+				from, to, time - lastTime, time > lastTime ? (ops - lastOps) / (time - lastTime) : 0.0);
+		from = to;
+		lastTime = time;
+		lastOps = ops;
+	}
+	writeMemoryStats(f);
+	fprintf(f,"________________________________________ \n\n");
+
+	fclose(f);
+}
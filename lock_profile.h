@@ -0,0 +1,248 @@
+/*
+ * Lock hold-time and wait-time profiler for the mutex and read write lock lists
+ *
+ * Compile with -DLOCK_PROFILE to enable, e.g.
+ *     gcc -g -Wall -DLOCK_PROFILE -o rw_linked_list rw_linked_list.c -lm -pthread
+ *
+ * Without LOCK_PROFILE the lock macros expand to the plain pthread calls, so the
+ * instrumentation has no cost when it is compiled out.
+ *
+ * */
+#ifndef LOCK_PROFILE_H
+#define LOCK_PROFILE_H
+
+#include <pthread.h>
+
+//Operation types, in the order threadOperation() picks them
+#define OP_MEMBER 0
+#define OP_INSERT 1
+#define OP_DELETE 2
+#define OP_TYPES 3
+
+#ifndef LOCK_PROFILE
+
+#define PROFILE_THREAD_START(id)
+#define MUTEX_LOCK(mutex_p, op) pthread_mutex_lock(mutex_p)
+#define MUTEX_UNLOCK(mutex_p, op) pthread_mutex_unlock(mutex_p)
+#define RW_RDLOCK(rwlock_p, op) pthread_rwlock_rdlock(rwlock_p)
+#define RW_WRLOCK(rwlock_p, op) pthread_rwlock_wrlock(rwlock_p)
+#define RW_UNLOCK(rwlock_p, op) pthread_rwlock_unlock(rwlock_p)
+#define WRITE_LOCK_PROFILE(f)
+
+#else
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+//Histogram buckets are powers of two nanoseconds, the last one is open ended
+#define HISTOGRAM_BUCKETS 40
+
+//Lock statistics of one operation type
+struct lock_stats_s {
+    unsigned long acquisitions;
+    unsigned long contended;
+    unsigned long long waitTotal;
+    unsigned long long holdTotal;
+    unsigned long waitHistogram[HISTOGRAM_BUCKETS];
+    unsigned long holdHistogram[HISTOGRAM_BUCKETS];
+};
+
+//Profile of one thread, kept in its own cache lines
+struct thread_profile_s {
+    struct lock_stats_s ops[OP_TYPES];
+    unsigned long long acquiredAt;
+    int readHeld;
+    int used;
+} __attribute__((aligned(64)));
+
+static struct thread_profile_s lockProfile[MAX_THREADS];
+static __thread struct thread_profile_s *threadProfile = NULL;
+
+//Number of readers currently holding the read write lock
+static int activeReaders = 0;
+
+//Read locks acquired while other readers held the lock
+static unsigned long sharedReads = 0;
+
+//Write lock attempts that found readers holding the lock
+static unsigned long writesBlockedByReaders = 0;
+
+static inline unsigned long long profileNow() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static inline int profileBucket(unsigned long long ns) {
+    int bucket = 0;
+
+    while (ns > 1 && bucket < HISTOGRAM_BUCKETS - 1) {
+        ns >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+static inline void profileThreadStart(int id) {
+    threadProfile = &lockProfile[id];
+    threadProfile->used = 1;
+}
+
+//Record the wait of an acquisition which started at startTime
+static inline void profileAcquired(int op, unsigned long long startTime, int contended) {
+    struct lock_stats_s *stats = &threadProfile->ops[op];
+    unsigned long long now = profileNow();
+
+    stats->acquisitions++;
+    stats->contended += contended;
+    stats->waitTotal += now - startTime;
+    stats->waitHistogram[profileBucket(now - startTime)]++;
+    threadProfile->acquiredAt = now;
+}
+
+//Record the hold time of the lock which is about to be released
+static inline void profileReleased(int op) {
+    struct lock_stats_s *stats = &threadProfile->ops[op];
+    unsigned long long held = profileNow() - threadProfile->acquiredAt;
+
+    stats->holdTotal += held;
+    stats->holdHistogram[profileBucket(held)]++;
+}
+
+static inline void profileMutexLock(pthread_mutex_t *mutex_p, int op) {
+    unsigned long long startTime = profileNow();
+    int contended = 0;
+
+    if (pthread_mutex_trylock(mutex_p) != 0) {
+        contended = 1;
+        pthread_mutex_lock(mutex_p);
+    }
+    profileAcquired(op, startTime, contended);
+}
+
+static inline void profileMutexUnlock(pthread_mutex_t *mutex_p, int op) {
+    profileReleased(op);
+    pthread_mutex_unlock(mutex_p);
+}
+
+static inline void profileRdlock(pthread_rwlock_t *rwlock_p, int op) {
+    unsigned long long startTime = profileNow();
+    int contended = 0;
+
+    if (pthread_rwlock_tryrdlock(rwlock_p) != 0) {
+        contended = 1;
+        pthread_rwlock_rdlock(rwlock_p);
+    }
+    if (__atomic_fetch_add(&activeReaders, 1, __ATOMIC_RELAXED) > 0)
+        __atomic_fetch_add(&sharedReads, 1, __ATOMIC_RELAXED);
+    threadProfile->readHeld = 1;
+    profileAcquired(op, startTime, contended);
+}
+
+static inline void profileWrlock(pthread_rwlock_t *rwlock_p, int op) {
+    unsigned long long startTime = profileNow();
+    int contended = 0;
+
+    if (pthread_rwlock_trywrlock(rwlock_p) != 0) {
+        contended = 1;
+        if (__atomic_load_n(&activeReaders, __ATOMIC_RELAXED) > 0)
+            __atomic_fetch_add(&writesBlockedByReaders, 1, __ATOMIC_RELAXED);
+        pthread_rwlock_wrlock(rwlock_p);
+    }
+    threadProfile->readHeld = 0;
+    profileAcquired(op, startTime, contended);
+}
+
+//The hold being released is a read whatever op it was taken for
+static inline void profileRwUnlock(pthread_rwlock_t *rwlock_p, int op) {
+    profileReleased(op);
+    if (threadProfile->readHeld) {
+        threadProfile->readHeld = 0;
+        __atomic_fetch_sub(&activeReaders, 1, __ATOMIC_RELAXED);
+    }
+    pthread_rwlock_unlock(rwlock_p);
+}
+
+//Approximate percentile of a histogram, as the upper bound of its bucket
+static inline unsigned long long profilePercentile(unsigned long histogram[], double fraction) {
+    unsigned long total = 0, seen = 0;
+    int i;
+
+    for (i = 0; i < HISTOGRAM_BUCKETS; i++)
+        total += histogram[i];
+    if (total == 0)
+        return 0;
+
+    for (i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += histogram[i];
+        if (seen >= fraction * total)
+            break;
+    }
+    return 1ULL << (i + 1);
+}
+
+//Write the contention summary of the run
+static inline void writeLockProfile(FILE *f) {
+    static const char *opNames[OP_TYPES] = {"Member", "Insert", "Delete"};
+    struct lock_stats_s total[OP_TYPES];
+    int i, op, b;
+
+    memset(total, 0, sizeof(total));
+    for (i = 0; i < MAX_THREADS; i++) {
+        if (!lockProfile[i].used)
+            continue;
+        for (op = 0; op < OP_TYPES; op++) {
+            struct lock_stats_s *stats = &lockProfile[i].ops[op];
+            total[op].acquisitions += stats->acquisitions;
+            total[op].contended += stats->contended;
+            total[op].waitTotal += stats->waitTotal;
+            total[op].holdTotal += stats->holdTotal;
+            for (b = 0; b < HISTOGRAM_BUCKETS; b++) {
+                total[op].waitHistogram[b] += stats->waitHistogram[b];
+                total[op].holdHistogram[b] += stats->holdHistogram[b];
+            }
+        }
+    }
+
+    fprintf(f,"Lock Profile (all samples, times in ns, percentiles are bucket upper bounds)\n");
+    for (op = 0; op < OP_TYPES; op++) {
+        unsigned long count = total[op].acquisitions;
+        if (count == 0)
+            continue;
+        fprintf(f,"  %s : acquisitions = %lu, contended = %lu (%.1f%%)\n", opNames[op], count,
+                total[op].contended, 100.0 * total[op].contended / count);
+        fprintf(f,"    wait mean = %.0f, p50 <= %llu, p99 <= %llu\n", (double) total[op].waitTotal / count,
+                profilePercentile(total[op].waitHistogram, 0.5), profilePercentile(total[op].waitHistogram, 0.99));
+        fprintf(f,"    hold mean = %.0f, p50 <= %llu, p99 <= %llu\n", (double) total[op].holdTotal / count,
+                profilePercentile(total[op].holdHistogram, 0.5), profilePercentile(total[op].holdHistogram, 0.99));
+    }
+
+    for (i = 0; i < MAX_THREADS; i++) {
+        unsigned long long wait = 0, hold = 0;
+        if (!lockProfile[i].used)
+            continue;
+        for (op = 0; op < OP_TYPES; op++) {
+            wait += lockProfile[i].ops[op].waitTotal;
+            hold += lockProfile[i].ops[op].holdTotal;
+        }
+        fprintf(f,"  Thread %d : total wait = %llu, total hold = %llu\n", i, wait, hold);
+    }
+
+    if (sharedReads > 0 || writesBlockedByReaders > 0) {
+        fprintf(f,"  Reads sharing the lock with other readers = %lu\n", sharedReads);
+        fprintf(f,"  Writes blocked by active readers = %lu\n", writesBlockedByReaders);
+    }
+}
+
+#define PROFILE_THREAD_START(id) profileThreadStart(id)
+#define MUTEX_LOCK(mutex_p, op) profileMutexLock(mutex_p, op)
+#define MUTEX_UNLOCK(mutex_p, op) profileMutexUnlock(mutex_p, op)
+#define RW_RDLOCK(rwlock_p, op) profileRdlock(rwlock_p, op)
+#define RW_WRLOCK(rwlock_p, op) profileWrlock(rwlock_p, op)
+#define RW_UNLOCK(rwlock_p, op) profileRwUnlock(rwlock_p, op)
+#define WRITE_LOCK_PROFILE(f) writeLockProfile(f)
+
+#endif
+
+#endif
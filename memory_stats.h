@@ -0,0 +1,83 @@
+/*
+ * Memory footprint accounting of the lists
+ *
+ * At the end of every sample the variants report the live nodes, the bytes they asked
+ * the allocator for, the bytes the allocator actually used for them (usable size plus
+ * the chunk header), the bytes retired but not yet freed, and the peak RSS of the
+ * sample. The peak RSS is reset at the start of each sample through /proc/self/clear_refs.
+ *
+ * */
+#ifndef MEMORY_STATS_H
+#define MEMORY_STATS_H
+
+#include <stdio.h>
+#include <string.h>
+#include <malloc.h>
+
+//Memory statistics of the run, summed over the samples
+static long memorySamples = 0;
+static double memoryLiveNodes = 0.0;
+static double memoryRequested = 0.0;
+static double memoryAllocated = 0.0;
+static double memoryRetired = 0.0;
+static double memoryPeakRss = 0.0;
+static long memoryPeakRssMax = 0;
+
+//Bytes the allocator uses for a block, its usable size plus the chunk header
+static inline size_t allocatedSize(void *block_p) {
+    return block_p == NULL ? 0 : malloc_usable_size(block_p) + sizeof(size_t);
+}
+
+//Reset the peak RSS of the process, so that it can be read per sample
+static inline void resetPeakRss() {
+    FILE *f = fopen("/proc/self/clear_refs", "w");
+    if (f != NULL) {
+        fputs("5", f);
+        fclose(f);
+    }
+}
+
+//Peak RSS (kB) since the last reset
+static inline long readPeakRss() {
+    char line[128];
+    long peak = 0;
+    FILE *f = fopen("/proc/self/status", "r");
+
+    if (f == NULL)
+        return 0;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (strncmp(line, "VmHWM:", 6) == 0) {
+            sscanf(line + 6, "%ld", &peak);
+            break;
+        }
+    }
+    fclose(f);
+    return peak;
+}
+
+static inline void recordMemory(long liveNodes, double requested, double allocated, double retired) {
+    long peakRss = readPeakRss();
+
+    memorySamples++;
+    memoryLiveNodes += liveNodes;
+    memoryRequested += requested;
+    memoryAllocated += allocated;
+    memoryRetired += retired;
+    memoryPeakRss += peakRss;
+    if (peakRss > memoryPeakRssMax)
+        memoryPeakRssMax = peakRss;
+}
+
+static inline void writeMemoryStats(FILE *f) {
+    if (memorySamples == 0 || memoryLiveNodes == 0)
+        return;
+
+    fprintf(f,"Live Nodes (mean) = %.1f\n", memoryLiveNodes / memorySamples);
+    fprintf(f,"Bytes per Live Node = %.2f (%.2f requested)\n", memoryAllocated / memoryLiveNodes,
+            memoryRequested / memoryLiveNodes);
+    fprintf(f,"Allocator Overhead = %.1f%%\n", 100 * (memoryAllocated - memoryRequested) / memoryRequested);
+    fprintf(f,"Retired not Freed (bytes, mean) = %.1f\n", memoryRetired / memorySamples);
+    fprintf(f,"Peak RSS per Sample (kB) mean = %.0f, max = %ld\n", memoryPeakRss / memorySamples, memoryPeakRssMax);
+}
+
+#endif
@@ -0,0 +1,181 @@
+/*
+ * Operation scheduler for the threaded lists
+ *
+ * By default every thread works through its own share of the operations, picking the
+ * type with rand() % 3 until each quota is used up, so the threads finish at different
+ * times and the sample lasts as long as the slowest one. With a schedule mode the
+ * operations of a sample are generated up front, with the exact number of each type in
+ * a random order, and split into chunks of CHUNK_OPS operations. Each thread gets a
+ * deque holding a contiguous range of chunks: it takes chunks from the bottom of its
+ * own deque, and with work stealing an idle thread takes them from the top of another
+ * thread's deque. A deque is a (top, bottom) pair packed into one word, so both ends
+ * are taken with a single compare and swap.
+ *
+ * The completion time of every thread is recorded in all modes, the skew between the
+ * first and the last thread to finish shows the imbalance.
+ *
+ * MAX_THREADS and the OP_ types (lock_profile.h) have to be defined before this file
+ * is included.
+ *
+ * */
+#ifndef OP_SCHEDULER_H
+#define OP_SCHEDULER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+//Schedule modes, 0 keeps the per thread quotas
+#define SCHEDULE_QUOTA 0
+#define SCHEDULE_STATIC 1
+#define SCHEDULE_STEALING 2
+
+//Operations handed out at a time
+#define CHUNK_OPS 64
+
+struct op_s {
+    int type;
+    int value;
+};
+
+//Chunks left to a thread, and when it ran out of work
+struct op_deque_s {
+    unsigned long range;
+    long steals;
+    double finish;
+} __attribute__((aligned(64)));
+
+static int scheduleMode = SCHEDULE_QUOTA;
+
+static struct op_s *opStream = NULL;
+static int opStreamLength = 0;
+static struct op_deque_s opDeques[MAX_THREADS];
+static int schedulerThreads = 0;
+static double schedulerStart = 0.0;
+
+//Completion skew (seconds) and its share of the sample, summed over the samples
+static double skewTotal = 0.0;
+static double relativeSkewTotal = 0.0;
+static long stealTotal = 0;
+static int schedulerSamples = 0;
+
+static inline double schedulerNow() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static inline unsigned long packRange(unsigned long top, unsigned long bottom) {
+    return (top << 32) | bottom;
+}
+
+//Generate the operations of a sample and deal their chunks out to the threads
+static inline void schedulerBegin(int noOfThreads, int noOfMember, int noOfInsert, int noOfDelete, int maxValue) {
+    int i, j, chunks;
+    struct op_s swap;
+
+    schedulerThreads = noOfThreads;
+    for (i = 0; i < noOfThreads; i++) {
+        opDeques[i].range = 0;
+        opDeques[i].steals = 0;
+        opDeques[i].finish = 0.0;
+    }
+
+    if (scheduleMode != SCHEDULE_QUOTA) {
+        opStreamLength = noOfMember + noOfInsert + noOfDelete;
+        opStream = malloc(sizeof(struct op_s) * (opStreamLength > 0 ? opStreamLength : 1));
+        for (i = 0; i < opStreamLength; i++) {
+            opStream[i].type = i < noOfMember ? OP_MEMBER : i < noOfMember + noOfInsert ? OP_INSERT : OP_DELETE;
+            opStream[i].value = rand() % maxValue;
+        }
+
+        //Fisher-Yates shuffle of the operation types
+        for (i = opStreamLength - 1; i > 0; i--) {
+            j = rand() % (i + 1);
+            swap = opStream[i];
+            opStream[i] = opStream[j];
+            opStream[j] = swap;
+        }
+
+        chunks = (opStreamLength + CHUNK_OPS - 1) / CHUNK_OPS;
+        for (i = 0; i < noOfThreads; i++)
+            opDeques[i].range = packRange((long) chunks * i / noOfThreads, (long) chunks * (i + 1) / noOfThreads);
+    }
+
+    schedulerStart = schedulerNow();
+}
+
+//Take a chunk from the bottom of a deque, or steal one from its top
+static inline int takeChunk(struct op_deque_s *deque_p, int isSteal) {
+    unsigned long range, top, bottom;
+
+    range = __atomic_load_n(&deque_p->range, __ATOMIC_ACQUIRE);
+    for (;;) {
+        top = range >> 32;
+        bottom = range & 0xffffffffUL;
+        if (top >= bottom)
+            return -1;
+        if (__atomic_compare_exchange_n(&deque_p->range, &range,
+                isSteal ? packRange(top + 1, bottom) : packRange(top, bottom - 1),
+                0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            return isSteal ? (int) top : (int) bottom - 1;
+    }
+}
+
+//Next chunk of operations for a thread, returns 0 when there is no work left
+static inline int nextChunk(int id, struct op_s **ops_pp, int *count_p) {
+    int chunk, i;
+
+    chunk = takeChunk(&opDeques[id], 0);
+    for (i = 1; chunk < 0 && scheduleMode == SCHEDULE_STEALING && i < schedulerThreads; i++) {
+        chunk = takeChunk(&opDeques[(id + i) % schedulerThreads], 1);
+        if (chunk >= 0)
+            opDeques[id].steals++;
+    }
+    if (chunk < 0)
+        return 0;
+
+    *ops_pp = opStream + (long) chunk * CHUNK_OPS;
+    *count_p = opStreamLength - chunk * CHUNK_OPS < CHUNK_OPS ? opStreamLength - chunk * CHUNK_OPS : CHUNK_OPS;
+    return 1;
+}
+
+//Called by a thread once it has no operations left
+static inline void schedulerThreadDone(int id) {
+    opDeques[id].finish = schedulerNow() - schedulerStart;
+}
+
+//Collect the completion skew of a sample
+static inline void schedulerEnd() {
+    double first, last;
+    int i;
+
+    first = last = opDeques[0].finish;
+    for (i = 0; i < schedulerThreads; i++) {
+        if (opDeques[i].finish < first)
+            first = opDeques[i].finish;
+        if (opDeques[i].finish > last)
+            last = opDeques[i].finish;
+        stealTotal += opDeques[i].steals;
+    }
+    skewTotal += last - first;
+    relativeSkewTotal += last > 0 ? (last - first) / last : 0.0;
+    schedulerSamples++;
+
+    free(opStream);
+    opStream = NULL;
+}
+
+static inline void writeSchedulerStats(FILE *f) {
+    if (schedulerSamples == 0)
+        return;
+
+    fprintf(f,"Schedule Mode = %s\n", scheduleMode == SCHEDULE_QUOTA ? "per thread quotas" :
+            scheduleMode == SCHEDULE_STATIC ? "static chunks" : "work stealing");
+    fprintf(f,"Completion Skew (ms, mean) = %f, %.2f%% of the slowest thread\n",
+            1000 * skewTotal / schedulerSamples, 100 * relativeSkewTotal / schedulerSamples);
+    if (scheduleMode == SCHEDULE_STEALING)
+        fprintf(f,"Steals per Sample = %f\n", (double) stealTotal / schedulerSamples);
+}
+
+#endif
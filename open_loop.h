@@ -0,0 +1,197 @@
+/*
+ * Open loop operation issue for the threaded lists
+ *
+ * By default the threads run closed loop : a thread issues its next operation as soon as
+ * the previous one finished, so a stalled lock also slows down the request stream and
+ * the stall never shows up in the timings. With an offered rate every thread issues its
+ * operations at intended times, offeredRate / noOfThreads per second with constant or
+ * exponential (Poisson) gaps, and the latency of an operation is measured from its
+ * intended time rather than from when it actually started, so time spent queued behind
+ * a stall is counted (no coordinated omission).
+ *
+ * Each run appends a point of the latency versus throughput curve to CURVE_FILE, keyed
+ * like the benchmark store by the GIT_REVISION of the environment and the configuration.
+ *
+ * MAX_THREADS has to be defined before this file is included.
+ *
+ * */
+#ifndef OPEN_LOOP_H
+#define OPEN_LOOP_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <sched.h>
+
+//Arrival processes, given after the offered rate
+#define ARRIVAL_CONSTANT 0
+#define ARRIVAL_POISSON 1
+
+#define CURVE_FILE "latency_curve.tsv"
+
+//Waits longer than this (seconds) sleep, shorter ones yield
+#define OPEN_LOOP_SPIN 0.00005
+
+//Offered rate (operations/sec) over all the threads, 0 for closed loop
+static double offeredRate = 0.0;
+static int arrivalMode = ARRIVAL_CONSTANT;
+
+//Schedule and latencies of one thread
+struct open_loop_s {
+    double next;
+    double meanGap;
+    unsigned int seed;
+    double *latencies;
+    int count;
+    int capacity;
+} __attribute__((aligned(64)));
+
+static struct open_loop_s openLoops[MAX_THREADS];
+static __thread struct open_loop_s *openLoop = NULL;
+static int openLoopThreads = 0;
+static double openLoopStart = 0.0;
+
+//Latencies (seconds) of all the samples, and the throughput achieved per sample
+static double *runLatencies = NULL;
+static long runLatencyCount = 0;
+static double achievedTotal = 0.0;
+static int openLoopSamples = 0;
+
+static inline double openLoopNow() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//Start the schedules of a sample, each thread records at most capacity latencies
+static inline void openLoopBegin(int noOfThreads, int capacity) {
+    int i;
+
+    if (offeredRate <= 0)
+        return;
+
+    openLoopThreads = noOfThreads;
+    openLoopStart = openLoopNow();
+    for (i = 0; i < noOfThreads; i++) {
+        openLoops[i].next = openLoopStart;
+        openLoops[i].meanGap = noOfThreads / offeredRate;
+        openLoops[i].seed = (unsigned int) time(NULL) ^ (i << 16);
+        openLoops[i].latencies = malloc(sizeof(double) * capacity);
+        openLoops[i].count = 0;
+        openLoops[i].capacity = capacity;
+    }
+}
+
+static inline void openLoopThreadStart(int id) {
+    openLoop = &openLoops[id];
+}
+
+//Wait until the intended time of the thread's next operation, and return it
+static inline double openLoopWait() {
+    double remaining;
+    struct timespec pause;
+
+    if (offeredRate <= 0)
+        return 0.0;
+
+    while ((remaining = openLoop->next - openLoopNow()) > 0) {
+        if (remaining > OPEN_LOOP_SPIN) {
+            remaining -= OPEN_LOOP_SPIN;
+            pause.tv_sec = (time_t) remaining;
+            pause.tv_nsec = (long) ((remaining - pause.tv_sec) * 1e9);
+            nanosleep(&pause, NULL);
+        } else {
+            //Yield rather than spin, the lock holder may need this core
+            sched_yield();
+        }
+    }
+    return openLoop->next;
+}
+
+//Record the latency of an operation issued at its intended time, and schedule the next one
+static inline void openLoopDone(double intended) {
+    double gap;
+
+    if (offeredRate <= 0)
+        return;
+
+    if (openLoop->count < openLoop->capacity)
+        openLoop->latencies[openLoop->count++] = openLoopNow() - intended;
+
+    if (arrivalMode == ARRIVAL_POISSON)
+        gap = -log(1.0 - (double) rand_r(&openLoop->seed) / ((double) RAND_MAX + 1.0)) * openLoop->meanGap;
+    else
+        gap = openLoop->meanGap;
+    openLoop->next += gap;
+}
+
+//Collect the latencies of a sample of noOfOperations operations, returns its wall time
+static inline double openLoopEnd(int noOfOperations) {
+    double wall = openLoopNow() - openLoopStart;
+    int i;
+
+    if (offeredRate <= 0)
+        return wall;
+
+    for (i = 0; i < openLoopThreads; i++) {
+        runLatencies = realloc(runLatencies, sizeof(double) * (runLatencyCount + openLoops[i].count));
+        memcpy(runLatencies + runLatencyCount, openLoops[i].latencies, sizeof(double) * openLoops[i].count);
+        runLatencyCount += openLoops[i].count;
+        free(openLoops[i].latencies);
+    }
+    achievedTotal += noOfOperations / wall;
+    openLoopSamples++;
+    return wall;
+}
+
+static int compareLatencies(const void *a, const void *b) {
+    double x = *(const double *) a, y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+//Latency percentile in microseconds, runLatencies must be sorted
+static inline double latencyPercentile(double fraction) {
+    long index = (long) (fraction * runLatencyCount);
+
+    if (runLatencyCount == 0)
+        return 0.0;
+    if (index >= runLatencyCount)
+        index = runLatencyCount - 1;
+    return runLatencies[index] * 1e6;
+}
+
+//Write the open loop results, and append the run's point to the curve
+static inline void writeOpenLoop(FILE *f, char *variant, int noOfThreads, int n, int m, float mMember, float mInsert,
+                                 float mDelete) {
+    char *revision = getenv("GIT_REVISION");
+    FILE *curve;
+    double achieved;
+
+    if (offeredRate <= 0 || openLoopSamples == 0)
+        return;
+
+    qsort(runLatencies, runLatencyCount, sizeof(double), compareLatencies);
+    achieved = achievedTotal / openLoopSamples;
+
+    fprintf(f,"Offered Rate (ops/sec) = %.0f, %s arrivals\n", offeredRate, arrivalMode == ARRIVAL_POISSON ? "poisson" : "constant");
+    fprintf(f,"Achieved Throughput (ops/sec) = %f\n", achieved);
+    fprintf(f,"Latency from Intended Start (us) p50 = %.1f, p90 = %.1f, p99 = %.1f, p99.9 = %.1f, max = %.1f\n",
+            latencyPercentile(0.5), latencyPercentile(0.9), latencyPercentile(0.99),
+            latencyPercentile(0.999), latencyPercentile(1.0));
+
+    curve = fopen(CURVE_FILE, "a");
+    if (curve == NULL) {
+        printf("Error occured while opening the file \n");
+        exit(1);
+    }
+    if (revision == NULL)
+        revision = "unknown";
+    fprintf(curve, "%s\t%s\t%d\t%d\t%d\t%.3f\t%.3f\t%.3f\t%s\t%.0f\t%.0f\t%.1f\t%.1f\t%.1f\t%.1f\n", revision, variant,
+            noOfThreads, n, m, mMember, mInsert, mDelete, arrivalMode == ARRIVAL_POISSON ? "poisson" : "constant", offeredRate, achieved,
+            latencyPercentile(0.5), latencyPercentile(0.99), latencyPercentile(0.999), latencyPercentile(1.0));
+    fclose(curve);
+}
+
+#endif
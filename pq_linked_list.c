@@ -0,0 +1,577 @@
+/*
+ * Sorted linked list used as a concurrent priority queue : Insert and PopMin
+ *
+ * The list is a lock free sorted list (Harris and Michael) after a sentinel head node. A
+ * node is taken by marking the low bit of its next pointer, which is the point at which
+ * it leaves the queue, and is unlinked afterwards by cleanFront() or by a traversal of
+ * Insert. Unlinked nodes are retired and freed at the end of the sample.
+ *
+ * popMode selects how the smallest key is taken :
+ *   0 - locked : Insert and PopMin under one mutex, exact head deletion
+ *   1 - exact  : lock free PopMin, every thread claims the first unclaimed node
+ *   2 - spray  : lock free PopMinApprox, a thread walks a random number of nodes in
+ *                [0, sprayWidth) from the head and claims the first unclaimed node from
+ *                there (as in the SprayList of Alistarh et al.), so concurrent pops are
+ *                spread over the front of the queue instead of fighting over one node
+ * The rank of every popped key, the number of unclaimed keys in front of it, measures
+ * how far a pop is from an exact one.
+ *
+ * Compile : gcc -g -Wall -o pq_linked_list pq_linked_list.c -lm -pthread
+ * Run : ./pq_linked_list noOfSamples n m noOfThreads mInsert mPop popMode
+ *
+ * */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <math.h>
+
+#include "memory_stats.h"
+#include "sample_clock.h"
+#include "sample_stats.h"
+
+#define MAX_THREADS 1024
+#define MAX_RANDOM 65535
+
+//Pop modes
+#define POP_LOCKED 0
+#define POP_EXACT 1
+#define POP_SPRAY 2
+
+//Spray width per additional thread, a single thread always pops the smallest key
+#define SPRAY_FACTOR 2
+
+// Number of samples
+int noOfSamples = 0;
+
+// Number of nodes in the linked list
+int n = 0;
+
+// Number of random operations in the linked list
+int m = 0;
+
+// Number of threads to execute
+int noOfThreads = 0;
+
+// Fractions of each operation
+float mInsert = 0.0, mPop = 0.0;
+
+// Total number of each operation
+int noOfInsert = 0, noOfPop = 0;
+
+// How the smallest key is taken
+int popMode = POP_LOCKED;
+char *popModeNames[] = {"locked", "exact", "spray"};
+
+// Nodes a spray walk may skip
+int sprayWidth = 1;
+
+//Node definition
+struct list_node_s {
+    int data;
+    struct list_node_s *next;
+    struct list_node_s *retiredNext;
+};
+
+//Sentinel before the smallest key
+struct list_node_s *head = NULL;
+
+//Unlinked nodes, freed at the end of the sample
+struct list_node_s *retired = NULL;
+
+pthread_mutex_t mutex;
+
+//Pop statistics of one thread
+struct thread_stats_s {
+    unsigned long pops;
+    unsigned long emptyPops;
+    unsigned long claimFailures;
+    unsigned long rankTotal;
+    unsigned long rankMax;
+} __attribute__((aligned(64)));
+
+struct thread_stats_s threadStats[MAX_THREADS];
+
+//Statistics of the run
+unsigned long totalPops = 0;
+unsigned long totalEmptyPops = 0;
+unsigned long totalClaimFailures = 0;
+unsigned long totalRank = 0;
+unsigned long maxRank = 0;
+
+int Insert(int value);
+
+int PopMin(int *value_p, struct thread_stats_s *stats_p);
+
+int PopMinApprox(int *value_p, struct thread_stats_s *stats_p, unsigned int *seed_p);
+
+int claimFrom(struct list_node_s *curr_p, int *value_p, struct thread_stats_s *stats_p, int rank);
+
+void cleanFront();
+
+void retireNode(struct list_node_s *node_p);
+
+double calcTime(clock_t startTime, clock_t endTime);
+
+void validateInput(int argc, char *argv[]);
+
+void populate(int n);
+
+void destroy();
+
+void measureMemory();
+
+void *threadOperation(void *id);
+
+void writeOutput(double mean, double std);
+
+int main(int argc, char *argv[]) {
+
+    //Retrieve and validate inputs
+    validateInput(argc, argv);
+
+	int sampleNumber = 0;
+
+	//Time spend for a particular sample
+	double sampleTime = 0;
+
+	//Mean of times of all the samples
+	double mean = 0;
+
+	//Standard deviation of all the samples
+	double std = 0;
+
+	//Time keeping variables
+    clock_t startTime, endTime;
+
+	//Wall time at which sampling started, used for the sampling time cap
+	time_t samplingStart = time(NULL);
+
+    //Random seed for random values
+    srand(time(NULL));
+
+	for(sampleNumber = 0; sampleNumber < noOfSamples; sampleNumber++){
+
+		//Defining threads
+		pthread_t* threadHandlers;
+		threadHandlers = malloc(sizeof(pthread_t) * noOfThreads);
+
+		// Calculating the total number of each operation
+		noOfInsert = mInsert * m;
+		noOfPop = m - noOfInsert;
+
+		int *threadId;
+		threadId = (int *)malloc(sizeof(int) * noOfThreads);
+
+		resetPeakRss();
+
+		//Populating the queue with random values
+		populate(n);
+
+		// Initializing the mutex
+		pthread_mutex_init(&mutex, NULL);
+
+		int i = 0;
+		for (i = 0; i < noOfThreads; i++) {
+			threadStats[i].pops = 0;
+			threadStats[i].emptyPops = 0;
+			threadStats[i].claimFailures = 0;
+			threadStats[i].rankTotal = 0;
+			threadStats[i].rankMax = 0;
+		}
+
+		//Recording time at operations start
+		startTime = clock();
+		sampleClockStart();
+		sampleClockThreads(noOfThreads);
+
+		// Thread Creation
+		for (i = 0; i < noOfThreads; i++) {
+			threadId[i] = i;
+			pthread_create(&threadHandlers[i], NULL, threadOperation, (void *) &threadId[i]);
+		}
+
+		// Thread Join
+		for (i = 0; i < noOfThreads; i++) {
+			pthread_join(threadHandlers[i], NULL);
+		}
+
+		//Recording the time at operation ends
+		endTime = clock();
+		sampleClockStop();
+
+		// Destroying the mutex
+		pthread_mutex_destroy(&mutex);
+
+		for (i = 0; i < noOfThreads; i++) {
+			totalPops += threadStats[i].pops;
+			totalEmptyPops += threadStats[i].emptyPops;
+			totalClaimFailures += threadStats[i].claimFailures;
+			totalRank += threadStats[i].rankTotal;
+			if (threadStats[i].rankMax > maxRank)
+				maxRank = threadStats[i].rankMax;
+		}
+
+		//Deallocate the memory of this sample's queue
+		measureMemory();
+		destroy();
+
+		//Deallocate the memory of this sample's thread handlers
+		free(threadHandlers);
+		free(threadId);
+
+		sampleTime = sampleClockTime(calcTime(startTime, endTime));
+		addSample(sampleTime);
+
+		//Stop as soon as the confidence target is met
+		if (isConfidenceReached())
+			break;
+
+		//Stop if the sampling time cap is exceeded
+		if (difftime(time(NULL), samplingStart) > MAX_SAMPLING_TIME)
+			break;
+	}
+
+	//Calculate mean for all the samples
+	mean = runningMean;
+
+	//Calculate Standard deviation for all the samples
+	std = findStd();
+
+	writeOutput(mean, std);
+	//Pops go in the delete fraction column
+	char variant[64];
+	snprintf(variant, sizeof(variant), "pq-%s", popModeNames[popMode]);
+	writeRecord(variant, noOfThreads, n, m, 0.0, mInsert, mPop, mean, std);
+
+    return 0;
+}
+
+
+//Marked pointers, the low bit of next is set once the node is popped
+static inline int isMarked(struct list_node_s *node_p) {
+    return ((uintptr_t) node_p & 1) != 0;
+}
+
+static inline struct list_node_s *marked(struct list_node_s *node_p) {
+    return (struct list_node_s *) ((uintptr_t) node_p | 1);
+}
+
+static inline struct list_node_s *unmarked(struct list_node_s *node_p) {
+    return (struct list_node_s *) ((uintptr_t) node_p & ~(uintptr_t) 1);
+}
+
+//Keep an unlinked node until the end of the sample
+void retireNode(struct list_node_s *node_p) {
+    struct list_node_s *top_p = __atomic_load_n(&retired, __ATOMIC_RELAXED);
+
+    do {
+        node_p->retiredNext = top_p;
+    } while (!__atomic_compare_exchange_n(&retired, &top_p, node_p, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+// Linked List Insertion function
+// Popped nodes met on the way are unlinked, a failed link starts the traversal again
+int Insert(int value) {
+    struct list_node_s *pred_p, *curr_p, *next_p;
+    struct list_node_s *temp_p = NULL;
+
+retry:
+    pred_p = head;
+    curr_p = unmarked(__atomic_load_n(&head->next, __ATOMIC_ACQUIRE));
+
+    while (curr_p != NULL) {
+        next_p = __atomic_load_n(&curr_p->next, __ATOMIC_ACQUIRE);
+        if (isMarked(next_p)) {
+            if (!__atomic_compare_exchange_n(&pred_p->next, &curr_p, unmarked(next_p), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+                goto retry;
+            retireNode(curr_p);
+            curr_p = unmarked(next_p);
+            continue;
+        }
+        if (curr_p->data >= value)
+            break;
+        pred_p = curr_p;
+        curr_p = next_p;
+    }
+
+    if (curr_p != NULL && curr_p->data == value) {
+        free(temp_p);
+        return 0;
+    }
+
+    if (temp_p == NULL) {
+        temp_p = malloc(sizeof(struct list_node_s));
+        temp_p->data = value;
+        temp_p->retiredNext = NULL;
+    }
+    temp_p->next = curr_p;
+    if (!__atomic_compare_exchange_n(&pred_p->next, &curr_p, temp_p, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        goto retry;
+    return 1;
+}
+
+//Unlink the popped nodes at the front of the list
+void cleanFront() {
+    struct list_node_s *curr_p = unmarked(__atomic_load_n(&head->next, __ATOMIC_ACQUIRE));
+    struct list_node_s *next_p, *expected_p;
+
+    while (curr_p != NULL) {
+        next_p = __atomic_load_n(&curr_p->next, __ATOMIC_ACQUIRE);
+        if (!isMarked(next_p))
+            return;
+        expected_p = curr_p;
+        if (__atomic_compare_exchange_n(&head->next, &expected_p, unmarked(next_p), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            retireNode(curr_p);
+            curr_p = unmarked(next_p);
+        } else {
+            curr_p = expected_p;
+        }
+    }
+}
+
+//Claim the first unclaimed node at or after curr_p, rank is the unclaimed nodes before curr_p
+//Returns 0 if the list ends first
+int claimFrom(struct list_node_s *curr_p, int *value_p, struct thread_stats_s *stats_p, int rank) {
+    struct list_node_s *next_p;
+
+    while (curr_p != NULL) {
+        next_p = __atomic_load_n(&curr_p->next, __ATOMIC_ACQUIRE);
+        if (isMarked(next_p)) {
+            curr_p = unmarked(next_p);
+            continue;
+        }
+        if (__atomic_compare_exchange_n(&curr_p->next, &next_p, marked(next_p), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            *value_p = curr_p->data;
+            stats_p->pops++;
+            stats_p->rankTotal += rank;
+            if (rank > stats_p->rankMax)
+                stats_p->rankMax = rank;
+            return 1;
+        }
+        //Another thread claimed it first, or a node was linked after it
+        stats_p->claimFailures++;
+    }
+    return 0;
+}
+
+// Exact PopMin, claims the first unclaimed node
+int PopMin(int *value_p, struct thread_stats_s *stats_p) {
+    if (!claimFrom(unmarked(__atomic_load_n(&head->next, __ATOMIC_ACQUIRE)), value_p, stats_p, 0)) {
+        stats_p->emptyPops++;
+        return 0;
+    }
+    cleanFront();
+    return 1;
+}
+
+// Relaxed PopMin, claims the first unclaimed node after a random walk from the head
+// A walk which runs off the end of the list falls back to the exact PopMin
+int PopMinApprox(int *value_p, struct thread_stats_s *stats_p, unsigned int *seed_p) {
+    struct list_node_s *curr_p = unmarked(__atomic_load_n(&head->next, __ATOMIC_ACQUIRE));
+    struct list_node_s *next_p;
+    int steps = rand_r(seed_p) % sprayWidth;
+    int rank = 0;
+
+    while (steps > 0 && curr_p != NULL) {
+        next_p = __atomic_load_n(&curr_p->next, __ATOMIC_ACQUIRE);
+        if (!isMarked(next_p))
+            rank++;
+        curr_p = unmarked(next_p);
+        steps--;
+    }
+
+    if (curr_p == NULL || !claimFrom(curr_p, value_p, stats_p, rank))
+        return PopMin(value_p, stats_p);
+
+    //The thread which landed on the head unlinks the popped prefix
+    if (rank == 0)
+        cleanFront();
+    return 1;
+}
+
+//Free every node of the list and the retired nodes, leaving it empty
+void destroy() {
+	struct list_node_s *curr_p = head;
+	struct list_node_s *next_p;
+
+	while (curr_p != NULL) {
+		next_p = unmarked(curr_p->next);
+		free(curr_p);
+		curr_p = next_p;
+	}
+	head = NULL;
+
+	for (curr_p = retired; curr_p != NULL; curr_p = next_p) {
+		next_p = curr_p->retiredNext;
+		free(curr_p);
+	}
+	retired = NULL;
+}
+
+//Record the memory footprint of the queue at the end of a sample
+//Popped nodes which are still linked count as retired
+void measureMemory() {
+	struct list_node_s *curr_p;
+	long live = 0, retiredNodes = 0;
+	double allocated = 0.0;
+
+	for (curr_p = unmarked(head->next); curr_p != NULL; curr_p = unmarked(curr_p->next)) {
+		if (isMarked(curr_p->next))
+			retiredNodes++;
+		else
+			live++;
+		allocated += allocatedSize(curr_p);
+	}
+	for (curr_p = retired; curr_p != NULL; curr_p = curr_p->retiredNext) {
+		retiredNodes++;
+		allocated += allocatedSize(curr_p);
+	}
+	recordMemory(live, (double) live * sizeof(struct list_node_s), allocated,
+			(double) retiredNodes * sizeof(struct list_node_s));
+}
+
+//Retrieve and validate the inputs
+void validateInput(int argc, char *argv[]) {
+
+
+    if (argc != 8) {
+        printf("Enter the command with arguments noOfSamples, n, m, noOfThreads, mInsert, mPop and popMode\n");
+        exit(0);
+    }
+
+    //Input retrieval
+	noOfSamples = (int) strtol(argv[1], (char**) NULL, 10);
+    n = (int) strtol(argv[2], (char**) NULL, 10);
+    m = (int) strtol(argv[3], (char**) NULL, 10);
+	noOfThreads = (int) strtol(argv[4], (char**) NULL, 10);
+    mInsert = (float) atof(argv[5]);
+    mPop = (float) atof(argv[6]);
+    popMode = (int) strtol(argv[7], (char**) NULL, 10);
+
+    //Input validation
+	if (noOfSamples <= 0){
+		printf("Invalid input for noOfSamples (noOfSamples > 0)\n");
+		exit(0);
+	} else if (n <= 0 || n >= MAX_RANDOM){
+		printf("Invalid input for n (0 < n < %d)\n", MAX_RANDOM);
+		exit(0);
+	}else if (m <= 0){
+		printf("Invalid input for m (m > 0)\n");
+		exit(0);
+
+	}else if (mInsert + mPop != 1.0){
+		printf("Invalid combination of fractions (Total = 1.0)\n");
+		exit(0);
+	}else if (popMode < POP_LOCKED || popMode > POP_SPRAY){
+		printf("Invalid popMode (0 = locked, 1 = exact, 2 = spray)\n");
+		exit(0);
+	}
+
+    //Input validation
+    if (noOfThreads <= 0 || noOfThreads > MAX_THREADS) {
+        printf("Invalid no. of Threads (0 < noOfThreads < %d)", MAX_THREADS);
+        exit(0);
+    }
+
+    sprayWidth = SPRAY_FACTOR * (noOfThreads - 1) + 1;
+}
+
+// Thread Operations
+// Each thread runs its share of each operation, picked in proportion to what is left,
+// with its own random state as rand() would serialize the threads on its lock
+void *threadOperation(void *threadId) {
+    int id = *(int *)threadId;
+    struct thread_stats_s *stats_p = &threadStats[id];
+    unsigned int seed = (unsigned int) time(NULL) ^ (id << 16);
+    int value;
+
+    //Number of each operations allocated for the thread
+    int insertLeft = noOfInsert / noOfThreads + (noOfInsert % noOfThreads > id ? 1 : 0);
+    int popLeft = noOfPop / noOfThreads + (noOfPop % noOfThreads > id ? 1 : 0);
+
+    sampleClockThreadStart();
+
+    while (insertLeft + popLeft > 0) {
+
+        int randomNumber = rand_r(&seed) % MAX_RANDOM;
+
+        if (rand_r(&seed) % (insertLeft + popLeft) < insertLeft) {
+            if (popMode == POP_LOCKED) {
+                pthread_mutex_lock(&mutex);
+                Insert(randomNumber);
+                pthread_mutex_unlock(&mutex);
+            } else
+                Insert(randomNumber);
+            insertLeft--;
+        }
+        else {
+            if (popMode == POP_LOCKED) {
+                pthread_mutex_lock(&mutex);
+                PopMin(&value, stats_p);
+                pthread_mutex_unlock(&mutex);
+            } else if (popMode == POP_EXACT)
+                PopMin(&value, stats_p);
+            else
+                PopMinApprox(&value, stats_p, &seed);
+            popLeft--;
+        }
+    }
+    return NULL;
+}
+
+//Queue population function, on a new list holding only the sentinel
+void populate(int n){
+
+	int i;
+
+	head = malloc(sizeof(struct list_node_s));
+	head->data = -1;
+	head->next = NULL;
+	head->retiredNext = NULL;
+
+	for(i=0; i<n; ){
+		if(Insert(rand() % MAX_RANDOM) == 1)
+			i++;
+	}
+}
+
+//Calculating time between operation start and end
+double calcTime(clock_t startTime, clock_t endTime) {
+    return (double) (endTime - startTime) / CLOCKS_PER_SEC;
+}
+
+void writeOutput(double mean, double std) {
+	FILE *f = fopen("results.txt", "a");
+	if (f == NULL)
+	{
+		printf("Error occured while opening the file \n");
+		exit(1);
+	}
+
+	fprintf(f,"\n === Priority Queue (%s PopMin) === \n\n", popModeNames[popMode]);
+	fprintf(f,"Number of Nodes = %d\n", n);
+	fprintf(f,"Number of Operations = %d\n", m);
+	fprintf(f,"Insert Fraction = %.3f\n", mInsert);
+	fprintf(f,"Pop Fraction = %.3f\n", mPop);
+	fprintf(f,"Number of Threads = %d\n", noOfThreads);
+	fprintf(f,"Sample Clock = %s\n", isSampleWallClock() ? "wall" : "cpu");
+	if (popMode == POP_SPRAY)
+		fprintf(f,"Spray Width = %d\n", sprayWidth);
+	fprintf(f,"Max Number of Samples = %d\n", noOfSamples);
+	fprintf(f,"Number of Samples = %d\n", acceptedSamples);
+	fprintf(f,"Rejected Outliers = %d\n", rejectedSamples);
+	fprintf(f,"Min number of samples needed = %f\n", minNoOfSamples);
+	fprintf(f,"Mean = %f\n", mean);
+	fprintf(f,"Standard Deviation = %f\n", std);
+	fprintf(f,"Throughput (ops/sec) = %f\n", mean > 0 ? m / mean : 0.0);
+	fprintf(f,"Confidence Interval (95%%) = +/- %f (%.2f%% of mean)\n", 1.96*std/sqrt(acceptedSamples), mean > 0 ? 100*1.96*std/sqrt(acceptedSamples)/mean : 0.0);
+	fprintf(f,"Pops = %lu, on an empty queue = %lu\n", totalPops, totalEmptyPops);
+	fprintf(f,"Claim Failures per Pop = %f\n", totalPops > 0 ? (double) totalClaimFailures / totalPops : 0.0);
+	fprintf(f,"Rank of Popped Key mean = %f, max = %lu\n", totalPops > 0 ? (double) totalRank / totalPops : 0.0, maxRank);
+	writeMemoryStats(f);
+	fprintf(f,"________________________________________ \n\n");
+
+	fclose(f);
+}
@@ -3,6 +3,8 @@
  *
  * Compile : gcc -g -Wall -o rw_linked_list rw_linked_list.c
  * Run : ./rw_linked_list noOfSamples n m noOfThreads mMember mInsert mDelete
+ *       [COMPACT_MODE=] [WAL_MODE=] [COMMIT_INTERVAL=] [OFFERED_RATE=] [ARRIVAL_MODE=]
+ *       [SCHEDULE_MODE=] [FINGER_MODE=] [LOCALITY=] in the environment (see "env_options.h")
  *
  * */
 #include <stdio.h>
@@ -10,11 +12,20 @@
 #include <time.h> 
 #include <pthread.h>
 #include <math.h>
+#include <unistd.h>
 
 
 #define MAX_THREADS 1024
 #define MAX_RANDOM 65535
 
+#include "lock_profile.h"
+#include "memory_stats.h"
+#include "sample_clock.h"
+#include "sample_stats.h"
+#include "env_options.h"
+#include "open_loop.h"
+#include "op_scheduler.h"
+
 // Number of samples
 int noOfSamples = 0;
 
@@ -33,10 +44,16 @@ float mInsert = 0.0, mDelete = 0.0, mMember = 0.0;
 // Total number of each operation
 int noOfInsert = 0, noOfDelete = 0, noOfMember = 0;
 
-//Minimum number of samples needed for confidence and accuracy
-float minNoOfSamples = 0.0;
-
 struct list_node_s** head = NULL;
+
+//Set to stop the background compaction thread
+int stopCompaction = 0;
+
+//Mean wall time per sample, and the result of replaying the log (last sample, matched over all)
+double walWallMean = 0.0;
+long walRecoveredRecords = 0;
+double walRecoveryTime = 0.0;
+int walRecoveryMatched = 1;
 pthread_rwlock_t rwlock;
 
 //Node definition
@@ -45,6 +62,9 @@ struct list_node_s {
     struct list_node_s *next;
 };
 
+#include "compaction.h"
+#include "finger.h"
+
 int Insert(int value, struct list_node_s **head_pp);
 
 int Delete(int value, struct list_node_s **head_pp);
@@ -55,14 +75,28 @@ double calcTime(clock_t startTime, clock_t endTime);
 
 void validateInput(int argc, char *argv[]);
 
+void Compact();
+
+int isSameList(struct list_node_s *a_p, struct list_node_s *b_p);
+
+double wallTime();
+
+void *compactionOperation();
+
 void populate(int n, struct list_node_s** head_p);
 
-double findStd(double timeArray[], int noOfSamples, double mean);
+void destroy(struct list_node_s **head_pp);
+
+void measureMemory(struct list_node_s *head_p);
+
+#include "wal.h"
 
 void *threadOperation(void *id);
 
 void writeOutput(double mean, double std);
 
+void variantName(char *variant, size_t size, int withRate);
+
 int main(int argc, char *argv[]) {
 
     //Retrieve and validate inputs
@@ -73,20 +107,26 @@ int main(int argc, char *argv[]) {
 	//Time spend for a particular sample
 	double sampleTime = 0;
 	
-	//Total time spent for all the samples
-	double totalTime = 0;
-	
 	//Mean of times of all the samples
 	double mean = 0;
 	
 	//Standard deviation of all the samples
 	double std = 0;  
 	
-	//Time values of all the samples
-	double timeArray[noOfSamples]; 
-	
 	//Time keeping variables 
     clock_t startTime, endTime;	
+	
+	//Wall time of a sample and of all the samples, which includes waiting for the log
+	double wallStart = 0, wallTotal = 0, wall = 0;
+	
+	//Traversal time of the list before compaction
+	double traversal = 0;
+	
+	//Background compaction thread
+	pthread_t compactionHandler;
+	
+	//Wall time at which sampling started, used for the sampling time cap
+	time_t samplingStart = time(NULL);
     
     //Random seed for random values
     srand(time(NULL));
@@ -106,6 +146,9 @@ int main(int argc, char *argv[]) {
 		threadId = (int *)malloc(sizeof(int) * noOfThreads);
 
 		head = malloc(sizeof(struct list_node_s));
+		resetCompaction();
+		resetPeakRss();
+		walOpen(noOfThreads);
 				
 		//Populating linked list with random values	
 		populate(n,head);
@@ -113,8 +156,25 @@ int main(int argc, char *argv[]) {
 		// Initializing the read write lock
 		pthread_rwlock_init(&rwlock, NULL);
 		
+		//Relinearize the list before the operations, or start the background compaction
+		if (compactMode == COMPACT_EXPLICIT) {
+			traversal = traverseTime(*head);
+			Compact();
+			recordTraversal(traversal, traverseTime(*head));
+		} else if (compactMode == COMPACT_BACKGROUND) {
+			traversal = traverseTime(*head);
+			stopCompaction = 0;
+			pthread_create(&compactionHandler, NULL, compactionOperation, NULL);
+		}
+		
 		//Recording time at operations start
 		startTime = clock();
+		sampleClockStart();
+		sampleClockThreads(noOfThreads);
+		wallStart = wallTime();
+		openLoopBegin(noOfThreads, m);
+		schedulerBegin(noOfThreads, noOfMember, noOfInsert, noOfDelete, MAX_RANDOM);
+		fingerBegin(noOfThreads);
 
 		// Thread Creation
 		int i = 0;
@@ -127,33 +187,75 @@ int main(int argc, char *argv[]) {
 		for (i = 0; i < noOfThreads; i++) {
 			pthread_join(threadHandlers[i], NULL);			
 		}
+
+		// Committing the rest of the log
+		walClose();
 		
 		//Recording the time at operation ends
 		endTime = clock();
+		sampleClockStop();
+		wallTotal += wallTime() - wallStart;
+		wall = openLoopEnd(m);
+		schedulerEnd();
+		fingerEnd();
+
+		// Stopping the background compaction
+		if (compactMode == COMPACT_BACKGROUND) {
+			__atomic_store_n(&stopCompaction, 1, __ATOMIC_RELAXED);
+			pthread_join(compactionHandler, NULL);
+			recordTraversal(traversal, traverseTime(*head));
+		}
     
 		// Destroying the read write lock
 		pthread_rwlock_destroy(&rwlock);
 
-		//Deallocate the memory of this sample's linked list
-		//free(head);
+		measureMemory(*head);
+
+		//Check that replaying this sample's log rebuilds the same list
+		struct list_node_s *recovered_p = NULL;
+		if (walMode != WAL_OFF) {
+			double recoveryStart = wallTime();
+			walRecoveredRecords = walRecover(&recovered_p);
+			walRecoveryTime = wallTime() - recoveryStart;
+			walRecoveryMatched &= isSameList(*head, recovered_p);
+		}
+
+		//Deallocate the memory of this sample's linked list, then of the recovered one
+		destroy(head);
+		free(head);
+		destroy(&recovered_p);
 		
 		//Deallocate the memory of this sample's thread handlers
 		free(threadHandlers);
+		free(threadId);
 		
-		sampleTime = calcTime(startTime, endTime);
-		timeArray[sampleNumber] = sampleTime;
-		totalTime = totalTime + sampleTime;
+		//Open loop samples are paced, so their wall time is what counts
+		sampleTime = offeredRate > 0 ? wall : sampleClockTime(calcTime(startTime, endTime));
+		addSample(sampleTime);
 		
 		//printf("Average time of sample %d = %f \n", sampleNumber, sampleTime);		
+
+		//Stop as soon as the confidence target is met
+		if (isConfidenceReached())
+			break;
+
+		//Stop if the sampling time cap is exceeded
+		if (difftime(time(NULL), samplingStart) > MAX_SAMPLING_TIME)
+			break;
 	}
 	
+	walWallMean = wallTotal / (acceptedSamples + rejectedSamples);
+
 	//Calculate mean for all the samples
-	mean = totalTime / noOfSamples;
+	mean = runningMean;
 	
 	//Calculate Standard deviation for all the samples
-	std = findStd(timeArray, noOfSamples, mean);
+	std = findStd();
 	
 	writeOutput(mean, std);
+	char variant[64];
+	variantName(variant, sizeof(variant), 1);
+	writeRecord(variant, noOfThreads, n, m, mMember, mInsert, mDelete, mean, std);
 	//printf("Average time spent = %f\n",mean);
 	//printf("Standard Deviation = %f\n",(std));
 
@@ -162,11 +264,18 @@ int main(int argc, char *argv[]) {
 
 
 // Linked List Membership function
+// The traversal starts from the thread's finger when it is before value
 int Member(int value, struct list_node_s *head_p) {
-    struct list_node_s *current_p = head_p;
+    struct list_node_s *pred_p = fingerStart(value);
+    struct list_node_s *current_p = pred_p != NULL ? pred_p->next : head_p;
+    long hops = 0;
 
-    while (current_p != NULL && current_p->data < value)
+    while (current_p != NULL && current_p->data < value) {
+        pred_p = current_p;
         current_p = current_p->next;
+        hops++;
+    }
+    fingerDone(pred_p, hops);
 
     if (current_p == NULL || current_p->data > value) {
         return 0;
@@ -179,13 +288,15 @@ int Member(int value, struct list_node_s *head_p) {
 
 // Linked List Insertion function
 int Insert(int value, struct list_node_s **head_pp) {
-    struct list_node_s *curr_p = *head_pp;
-    struct list_node_s *pred_p = NULL;
+    struct list_node_s *pred_p = fingerStart(value);
+    struct list_node_s *curr_p = pred_p != NULL ? pred_p->next : *head_pp;
     struct list_node_s *temp_p = NULL;
+    long hops = 0;
 
     while (curr_p != NULL && curr_p->data < value) {
         pred_p = curr_p;
         curr_p = curr_p->next;
+        hops++;
     }
 
     if (curr_p == NULL || curr_p->data > value) {
@@ -198,30 +309,41 @@ int Insert(int value, struct list_node_s **head_pp) {
         else
             pred_p->next = temp_p;
 
+        noteInserted();
+        fingerDone(temp_p, hops);
         return 1;
     }
-    else
+    else {
+        fingerDone(pred_p, hops);
         return 0;
+    }
 }
 
 // Linked List Deletion function
+// Fingers on the deleted node are dropped before it is freed
 int Delete(int value, struct list_node_s **head_pp) {
-    struct list_node_s *curr_p = *head_pp;
-    struct list_node_s *pred_p = NULL;
+    struct list_node_s *pred_p = fingerStart(value);
+    struct list_node_s *curr_p = pred_p != NULL ? pred_p->next : *head_pp;
+    long hops = 0;
 
     while (curr_p != NULL && curr_p->data < value) {
         pred_p = curr_p;
         curr_p = curr_p->next;
+        hops++;
     }
+    fingerDone(pred_p, hops);
 
     if (curr_p != NULL && curr_p->data == value) {
+        fingerRelease(curr_p);
         if (pred_p == NULL) {
             *head_pp = curr_p->next;
-            free(curr_p);
+            noteDeleted(curr_p);
+            freeNode(curr_p);
         }
         else {
             pred_p->next = curr_p->next;
-            free(curr_p);
+            noteDeleted(curr_p);
+            freeNode(curr_p);
         }
 
         return 1;
@@ -231,12 +353,36 @@ int Delete(int value, struct list_node_s **head_pp) {
         return 0;
 }
 
+//Free every node of the list together with its region, leaving it empty
+void destroy(struct list_node_s **head_pp) {
+	releaseList(*head_pp, &region);
+	region.nodes = NULL;
+	region.count = 0;
+	*head_pp = NULL;
+}
+
+//Record the memory footprint of the list at the end of a sample
+//A compacted region is one allocation, its holes are retired until it is replaced
+void measureMemory(struct list_node_s *head_p) {
+	struct list_node_s *curr_p;
+	long live = 0;
+	double allocated = allocatedSize(region.nodes);
+
+	for (curr_p = head_p; curr_p != NULL; curr_p = curr_p->next) {
+		live++;
+		if (!isInRegion(&region, curr_p))
+			allocated += allocatedSize(curr_p);
+	}
+	recordMemory(live, (double) live * sizeof(struct list_node_s), allocated,
+			(double) retiredNodes * sizeof(struct list_node_s));
+}
+
 //Retrieve and validate the inputs
 void validateInput(int argc, char *argv[]) {
 
     
     if (argc != 8) {
-        printf("Enter the command with arguments noOfSamples, n, m, noOfThreads, mMember, mInsert and mDelete\n");
+        printf("Enter the command with arguments noOfSamples, n, m, noOfThreads, mMember, mInsert, mDelete\n");
         exit(0);
     }
     
@@ -248,6 +394,14 @@ void validateInput(int argc, char *argv[]) {
     mMember = (float) atof(argv[5]);
     mInsert = (float) atof(argv[6]);
     mDelete = (float) atof(argv[7]);
+    compactMode = envInt("COMPACT_MODE", compactMode);
+    walMode = envInt("WAL_MODE", walMode);
+    walCommitInterval = envInt("COMMIT_INTERVAL", walCommitInterval);
+    offeredRate = envDouble("OFFERED_RATE", offeredRate);
+    arrivalMode = envInt("ARRIVAL_MODE", arrivalMode);
+    scheduleMode = envInt("SCHEDULE_MODE", scheduleMode);
+    fingerMode = envInt("FINGER_MODE", fingerMode);
+    locality = envDouble("LOCALITY", locality);
 
     //Input validation
 	if (noOfSamples <= 0){
@@ -270,6 +424,43 @@ void validateInput(int argc, char *argv[]) {
         printf("Invalid no. of Threads (0 < noOfThreads < %d)", MAX_THREADS);
         exit(0);
     }
+
+    if (compactMode < COMPACT_OFF || compactMode > COMPACT_BACKGROUND) {
+        printf("Invalid COMPACT_MODE (0 = off, 1 = explicit, 2 = background)\n");
+        exit(0);
+    }
+
+    if (walMode < WAL_OFF || walMode > WAL_SYNC) {
+        printf("Invalid WAL_MODE (0 = off, 1 = asynchronous, 2 = synchronous)\n");
+        exit(0);
+    } else if (walCommitInterval <= 0) {
+        printf("Invalid COMMIT_INTERVAL (COMMIT_INTERVAL > 0)\n");
+        exit(0);
+    }
+
+    if (offeredRate < 0) {
+        printf("Invalid OFFERED_RATE (0 = closed loop, > 0 operations/sec)\n");
+        exit(0);
+    } else if (arrivalMode < ARRIVAL_CONSTANT || arrivalMode > ARRIVAL_POISSON) {
+        printf("Invalid ARRIVAL_MODE (0 = constant, 1 = poisson)\n");
+        exit(0);
+    }
+
+    if (scheduleMode < SCHEDULE_QUOTA || scheduleMode > SCHEDULE_STEALING) {
+        printf("Invalid SCHEDULE_MODE (0 = per thread quotas, 1 = static chunks, 2 = work stealing)\n");
+        exit(0);
+    }
+
+    if (fingerMode < FINGER_OFF || fingerMode > FINGER_ON) {
+        printf("Invalid FINGER_MODE (0 = off, 1 = on)\n");
+        exit(0);
+    } else if (locality < 0 || locality > 1) {
+        printf("Invalid LOCALITY (0 <= LOCALITY <= 1)\n");
+        exit(0);
+    } else if (locality > 0 && scheduleMode != SCHEDULE_QUOTA) {
+        printf("A LOCALITY needs the per thread quotas (SCHEDULE_MODE=0)\n");
+        exit(0);
+    }
 }
 
 // Thread Operations
@@ -282,6 +473,47 @@ void *threadOperation(void *threadId) {
     int noOfThreadMember = 0;
 
     int id = *(int *)threadId; 
+
+    sampleClockThreadStart();
+    PROFILE_THREAD_START(id);
+    walThreadStart(id);
+    openLoopThreadStart(id);
+    fingerThreadStart(id);
+
+    //Intended start of the next operation in open loop
+    double intended = 0;
+
+    //Chunks of the generated operations, taken from the scheduler
+    struct op_s *ops = NULL;
+    int count = 0, k = 0;
+
+    if (scheduleMode != SCHEDULE_QUOTA) {
+        while (nextChunk(id, &ops, &count)) {
+            for (k = 0; k < count; k++) {
+                intended = openLoopWait();
+                if (ops[k].type == OP_MEMBER) {
+                    RW_RDLOCK(&rwlock, OP_MEMBER);
+                    Member(ops[k].value, *head);
+                    RW_UNLOCK(&rwlock, OP_MEMBER);
+                } else if (ops[k].type == OP_INSERT) {
+                    RW_WRLOCK(&rwlock, OP_INSERT);
+                    if (Insert(ops[k].value, head))
+                        walAppend(WAL_INSERT, ops[k].value);
+                    RW_UNLOCK(&rwlock, OP_INSERT);
+                    walWait();
+                } else {
+                    RW_WRLOCK(&rwlock, OP_DELETE);
+                    if (Delete(ops[k].value, head))
+                        walAppend(WAL_DELETE, ops[k].value);
+                    RW_UNLOCK(&rwlock, OP_DELETE);
+                    walWait();
+                }
+                openLoopDone(intended);
+            }
+        }
+        schedulerThreadDone(id);
+        return NULL;
+    }
     
     //Calculate the number of member operations per thread
     if (noOfMember % noOfThreads <= id) {
@@ -320,23 +552,29 @@ void *threadOperation(void *threadId) {
 
     while (totalExecuted < noOfThreadTotal) {
 
-        int randomNumber = rand() % MAX_RANDOM;
+        int randomNumber = fingerKey(MAX_RANDOM);
         int randomOperation = rand() % 3;
 
         if (randomOperation == 0 && isMemberFinished == 0) {
             if (memberExecuted < noOfThreadMember) {
-                pthread_rwlock_rdlock(&rwlock);
+                intended = openLoopWait();
+                RW_RDLOCK(&rwlock, OP_MEMBER);
                 Member(randomNumber, *head);
-                pthread_rwlock_unlock(&rwlock);
+                RW_UNLOCK(&rwlock, OP_MEMBER);
+                openLoopDone(intended);
                 memberExecuted++;
             } else
                 isMemberFinished = 1;
         }
         else if (randomOperation == 1 && isInsertFinished == 0) {
             if (insertExecuted < noOfThreadInsert) {
-                pthread_rwlock_wrlock(&rwlock);
-                Insert(randomNumber, head);
-                pthread_rwlock_unlock(&rwlock);
+                intended = openLoopWait();
+                RW_WRLOCK(&rwlock, OP_INSERT);
+                if (Insert(randomNumber, head))
+                    walAppend(WAL_INSERT, randomNumber);
+                RW_UNLOCK(&rwlock, OP_INSERT);
+                walWait();
+                openLoopDone(intended);
                 insertExecuted++;
             } else
                 isInsertFinished = 1;
@@ -344,24 +582,95 @@ void *threadOperation(void *threadId) {
         else if (randomOperation == 2 && isDeleteFinished == 0) {
 
             if (deleteExecuted < noOfThreadDelete) {
-                pthread_rwlock_wrlock(&rwlock);
-                Delete(randomNumber, head);
-                pthread_rwlock_unlock(&rwlock);
+                intended = openLoopWait();
+                RW_WRLOCK(&rwlock, OP_DELETE);
+                if (Delete(randomNumber, head))
+                    walAppend(WAL_DELETE, randomNumber);
+                RW_UNLOCK(&rwlock, OP_DELETE);
+                walWait();
+                openLoopDone(intended);
                 deleteExecuted++;
             } else
                 isDeleteFinished = 1;
         }
         totalExecuted = insertExecuted + memberExecuted + deleteExecuted;   
     }
+    schedulerThreadDone(id);
     return NULL;
 }
 
 
+//Relinearize the list into a contiguous region
+//The copy is taken under the read lock, so only the swap pauses the readers
+void Compact() {
+	struct region_s newRegion, oldRegion;
+	struct list_node_s *newHead_p, *oldHead_p;
+	unsigned long version;
+	double pauseStart;
+
+	pthread_rwlock_rdlock(&rwlock);
+	version = modifications;
+	newHead_p = copyList(*head, &newRegion);
+	pthread_rwlock_unlock(&rwlock);
+
+	pthread_rwlock_wrlock(&rwlock);
+	pauseStart = compactNow();
+	if (modifications != version) {
+		//The list changed during the copy, take it again under the write lock
+		free(newRegion.nodes);
+		newHead_p = copyList(*head, &newRegion);
+	}
+	oldHead_p = *head;
+	oldRegion = region;
+	*head = newHead_p;
+	region = newRegion;
+	scatteredNodes = 0;
+	retiredNodes = 0;
+	fingerReleaseAll();
+	pthread_rwlock_unlock(&rwlock);
+	recordCompaction(compactNow() - pauseStart);
+
+	//No thread can reach the old list any more
+	releaseList(oldHead_p, &oldRegion);
+}
+
+//Background compaction, triggered when the fragmentation exceeds COMPACT_THRESHOLD
+void *compactionOperation() {
+	double currentFragmentation;
+
+	while (!__atomic_load_n(&stopCompaction, __ATOMIC_RELAXED)) {
+		usleep(COMPACT_INTERVAL);
+
+		pthread_rwlock_rdlock(&rwlock);
+		currentFragmentation = fragmentation();
+		pthread_rwlock_unlock(&rwlock);
+
+		if (currentFragmentation > COMPACT_THRESHOLD)
+			Compact();
+	}
+	return NULL;
+}
+
+//Check whether two lists hold the same keys
+int isSameList(struct list_node_s *a_p, struct list_node_s *b_p) {
+	while (a_p != NULL && b_p != NULL && a_p->data == b_p->data) {
+		a_p = a_p->next;
+		b_p = b_p->next;
+	}
+	return a_p == NULL && b_p == NULL;
+}
+
+//Wall clock time in seconds
+double wallTime() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
 //Linked list population function
 void populate(int n, struct list_node_s** head_p){
 	
 	int num,i;
-	int inserted;
 	*head_p = malloc(sizeof(struct list_node_s));
   
 	for(i=0; i<n; ){
@@ -369,13 +678,15 @@ void populate(int n, struct list_node_s** head_p){
 		
 		if(i==0){
 			(*head_p)->data = num;
+			(*head_p)->next = NULL;
+			noteInserted();
+			walAppend(WAL_INSERT, num);
+			i++;
+		}
+		else if(Insert(num, head_p) == 1){
+			walAppend(WAL_INSERT, num);
 			i++;
 		}
-		else
-			inserted = Insert(num, head_p);
-		  
-		if(inserted == 1)
-			i++;	  
 	}
 }
 
@@ -384,27 +695,8 @@ double calcTime(clock_t startTime, clock_t endTime) {
     return (double) (endTime - startTime) / CLOCKS_PER_SEC;
 }
 
-//Standard Deviation calculating function
-double findStd(double timeArray[], int noOfSamples, double mean){
-	
-  int i;
-  float std=0;
-  float temp=0.0;
-  
-  for(i=0; i<noOfSamples; i++){
-    timeArray[i] -= mean;
-    temp = timeArray[i]*timeArray[i];
-    std += temp;
-  }
-  
-  std = std/noOfSamples;
-  std = sqrt(std);
-  minNoOfSamples = pow((100*1.96*std)/(5*mean),2);
-  //printf("Minimum no. of samples needed = %f\n", minNoOfSamples);
-  return std;
-}
-
 void writeOutput(double mean, double std) {
+	char variant[64];
 	FILE *f = fopen("results.txt", "a"); 
 	if (f == NULL)
 	{
@@ -412,16 +704,55 @@ void writeOutput(double mean, double std) {
 		exit(1);
 	}
 	
+	variantName(variant, sizeof(variant), 0);
+
 	fprintf(f,"\n === Read Write Lock === \n\n"); 
+	fprintf(f,"Number of Nodes = %d\n", n);
+	fprintf(f,"Number of Operations = %d\n", m);
 	fprintf(f,"Member Fraction= %.2f\n", mMember);  
 	fprintf(f,"Insert Fraction = %.3f\n", mInsert);  
 	fprintf(f,"Delete Fraction = %.3f\n", mDelete); 
 	fprintf(f,"Number of Threads = %d\n", noOfThreads); 
-	fprintf(f,"Number of Samples = %d\n", noOfSamples);   
+	fprintf(f,"Max Number of Samples = %d\n", noOfSamples);
+	fprintf(f,"Number of Samples = %d\n", acceptedSamples);
+	fprintf(f,"Rejected Outliers = %d\n", rejectedSamples);
 	fprintf(f,"Min number of samples needed = %f\n", minNoOfSamples);  
 	fprintf(f,"Mean = %f\n", mean);  
-	fprintf(f,"Standard Deviation = %f\n", std);             
+	fprintf(f,"Standard Deviation = %f\n", std);
+	fprintf(f,"Throughput (ops/sec) = %f\n", mean > 0 ? m / mean : 0.0);
+	fprintf(f,"Confidence Interval (95%%) = +/- %f (%.2f%% of mean)\n", 1.96*std/sqrt(acceptedSamples), mean > 0 ? 100*1.96*std/sqrt(acceptedSamples)/mean : 0.0);
+	WRITE_LOCK_PROFILE(f);
+	writeCompactionStats(f);
+	writeMemoryStats(f);
+	writeOpenLoop(f, variant, noOfThreads, n, m, mMember, mInsert, mDelete);
+	writeSchedulerStats(f);
+	writeFingerStats(f);
+	if (walMode != WAL_OFF) {
+		fprintf(f,"Durability Mode = %s, commit interval = %d us\n", walMode == WAL_SYNC ? "synchronous" : "asynchronous", walCommitInterval);
+		fprintf(f,"Wall Time Mean = %f\n", walWallMean);
+		fprintf(f,"Wall Throughput (ops/sec) = %f\n", walWallMean > 0 ? m / walWallMean : 0.0);
+		fprintf(f,"Group Commits = %lu, records per commit = %f\n", walCommits, walCommits > 0 ? (double) walRecords / walCommits : 0.0);
+		fprintf(f,"Recovery = %ld records replayed in %f sec, list %s\n", walRecoveredRecords, walRecoveryTime, walRecoveryMatched ? "matches" : "DOES NOT MATCH");
+		fprintf(f,"Recovery Dropped = %ld records after a sequence gap, %ld bytes of a torn record\n", walDroppedRecords, walTornBytes);
+	}
 	fprintf(f,"________________________________________ \n\n");                   
 	
 	fclose(f); 
 }
+
+
+//Name of the configuration, with the offered rate for the benchmark store
+//The latency curve keeps the rate in a column of its own
+void variantName(char *variant, size_t size, int withRate) {
+	char rate[32] = "", local[32] = "";
+
+	if (withRate && offeredRate > 0)
+		snprintf(rate, sizeof(rate), "-open%.0f", offeredRate);
+	if (locality > 0)
+		snprintf(local, sizeof(local), "-local%.2f", locality);
+	snprintf(variant, size, "rw%s%s%s%s%s%s",
+			compactMode == COMPACT_OFF ? "" : compactMode == COMPACT_EXPLICIT ? "-compact" : "-bgcompact",
+			walMode == WAL_OFF ? "" : walMode == WAL_ASYNC ? "-wal-async" : "-wal-sync",
+			scheduleMode == SCHEDULE_QUOTA ? "" : scheduleMode == SCHEDULE_STATIC ? "-static" : "-stealing",
+			fingerMode == FINGER_ON ? "-finger" : "", local, rate);
+}
@@ -0,0 +1,110 @@
+/*
+ * Clock the sample times are taken on
+ *
+ * The lists time a sample with clock(), the CPU time of the process, which is summed
+ * over the threads and so does not fall as threads are added on more cores. With
+ * SAMPLE_CLOCK=wall in the environment the samples are timed on the monotonic wall
+ * clock instead, as the scaling sweep needs (see sweep.sh).
+ *
+ * A threaded list also calls sampleClockThreads() before creating its threads and
+ * sampleClockThreadStart() first thing in each of them. Every thread takes its arrival
+ * time before it waits at a barrier, and sampleClockStop() starts the sample at the
+ * latest arrival, so thread creation is not timed as part of the sample. The barrier
+ * cannot tell which thread came last (PTHREAD_BARRIER_SERIAL_THREAD goes to any one of
+ * them, after the others are already released), hence the maximum of the arrivals.
+ *
+ *     startTime = clock();    sampleClockStart();
+ *                             sampleClockThreads(noOfThreads);
+ *     endTime = clock();      sampleClockStop();
+ *     sampleTime = sampleClockTime(calcTime(startTime, endTime));
+ *
+ * */
+#ifndef SAMPLE_CLOCK_H
+#define SAMPLE_CLOCK_H
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//-1 until the environment is read
+static int sampleWallClock = -1;
+
+static double sampleClockWallStart = 0.0;
+static double sampleClockWallEnd = 0.0;
+
+//Threads the wall clock waits for, 0 when there is no barrier
+static int sampleClockBarrierThreads = 0;
+static pthread_barrier_t sampleClockBarrier;
+
+//Latest arrival (ns) of a thread at the barrier
+static long long sampleClockLastArrival = 0;
+
+static inline int isSampleWallClock() {
+    char *clock_p;
+
+    if (sampleWallClock < 0) {
+        clock_p = getenv("SAMPLE_CLOCK");
+        sampleWallClock = clock_p != NULL && strcmp(clock_p, "wall") == 0;
+    }
+    return sampleWallClock;
+}
+
+static inline double sampleWallTime() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static inline long long sampleWallTimeNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static inline void sampleClockStart() {
+    if (isSampleWallClock())
+        sampleClockWallStart = sampleWallTime();
+}
+
+static inline void sampleClockThreads(int noOfThreads) {
+    if (isSampleWallClock() && noOfThreads > 0) {
+        pthread_barrier_init(&sampleClockBarrier, NULL, noOfThreads);
+        sampleClockBarrierThreads = noOfThreads;
+        sampleClockLastArrival = 0;
+    }
+}
+
+//Records the thread's arrival and waits for every thread of the sample
+static inline void sampleClockThreadStart() {
+    long long arrival;
+    long long latest;
+
+    if (sampleClockBarrierThreads == 0)
+        return;
+
+    arrival = sampleWallTimeNs();
+    latest = __atomic_load_n(&sampleClockLastArrival, __ATOMIC_RELAXED);
+    while (arrival > latest && !__atomic_compare_exchange_n(&sampleClockLastArrival, &latest,
+            arrival, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+    pthread_barrier_wait(&sampleClockBarrier);
+}
+
+//Called after the threads are joined, the sample starts at the latest arrival
+static inline void sampleClockStop() {
+    if (isSampleWallClock())
+        sampleClockWallEnd = sampleWallTime();
+    if (sampleClockBarrierThreads > 0) {
+        sampleClockWallStart = sampleClockLastArrival / 1e9;
+        pthread_barrier_destroy(&sampleClockBarrier);
+        sampleClockBarrierThreads = 0;
+    }
+}
+
+//Time of the sample, cpuTime unless the wall clock was asked for
+static inline double sampleClockTime(double cpuTime) {
+    return isSampleWallClock() ? sampleClockWallEnd - sampleClockWallStart : cpuTime;
+}
+
+#endif
@@ -0,0 +1,104 @@
+/*
+ * Sampling statistics and the benchmark store shared by the lists
+ *
+ * Every sample time goes through addSample(), which keeps a running mean and variance
+ * (Welford's method) of the accepted samples. After the PILOT_SAMPLES pilot batch a
+ * sample further than OUTLIER_THRESHOLD standard deviations from the mean is rejected,
+ * and sampling stops as soon as isConfidenceReached() (95% confidence, 5% accuracy) or
+ * after MAX_SAMPLING_TIME seconds.
+ *
+ * writeRecord() appends the statistics of a configuration to the benchmark store,
+ * keyed by the GIT_REVISION of the environment (see compare_results.c).
+ *
+ * */
+#ifndef SAMPLE_STATS_H
+#define SAMPLE_STATS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+//Samples always run before the confidence criterion is checked
+#define PILOT_SAMPLES 10
+
+//Samples further than this many standard deviations from the mean are rejected
+#define OUTLIER_THRESHOLD 3.0
+
+//Maximum wall time (seconds) spent on sampling a single configuration
+#define MAX_SAMPLING_TIME 120
+
+#define RECORD_FILE "benchmarks.tsv"
+
+//Minimum number of samples needed for confidence and accuracy
+static float minNoOfSamples = 0.0;
+
+//Running statistics of the accepted samples (Welford's method)
+static int acceptedSamples = 0;
+static int rejectedSamples = 0;
+static double runningMean = 0.0;
+static double runningM2 = 0.0;
+
+//Standard Deviation calculating function
+static inline double findStd() {
+    double std = 0.0;
+
+    if (acceptedSamples == 0)
+        return 0.0;
+
+    std = sqrt(runningM2 / acceptedSamples);
+    if (runningMean > 0)
+        minNoOfSamples = pow((100 * 1.96 * std) / (5 * runningMean), 2);
+    else
+        minNoOfSamples = 0.0;
+    return std;
+}
+
+//Add a sample to the running statistics, rejecting outliers once the pilot batch is done
+static inline int addSample(double sampleTime) {
+    double delta = 0.0;
+    double std = 0.0;
+
+    if (acceptedSamples >= PILOT_SAMPLES) {
+        std = findStd();
+        if (std > 0 && fabs(sampleTime - runningMean) > OUTLIER_THRESHOLD * std) {
+            rejectedSamples++;
+            return 0;
+        }
+    }
+
+    acceptedSamples++;
+    delta = sampleTime - runningMean;
+    runningMean += delta / acceptedSamples;
+    runningM2 += delta * (sampleTime - runningMean);
+    return 1;
+}
+
+//Check whether the 95% confidence / 5% accuracy target has been met
+static inline int isConfidenceReached() {
+    if (acceptedSamples < PILOT_SAMPLES)
+        return 0;
+
+    findStd();
+    return acceptedSamples >= minNoOfSamples;
+}
+
+//Append a configuration's statistics to the benchmark store, keyed by revision
+static inline void writeRecord(char *variant, int threads, int n, int m, float mMember,
+                               float mInsert, float mDelete, double mean, double std) {
+    char *revision = getenv("GIT_REVISION");
+    FILE *f = fopen(RECORD_FILE, "a");
+    if (f == NULL) {
+        printf("Error occured while opening the file \n");
+        exit(1);
+    }
+
+    if (revision == NULL)
+        revision = "unknown";
+
+    fprintf(f, "%s\t%s\t%d\t%d\t%d\t%.3f\t%.3f\t%.3f\t%d\t%f\t%f\n", revision, variant,
+            threads, n, m, mMember, mInsert, mDelete, acceptedSamples, mean, std);
+
+    fclose(f);
+}
+
+#endif
@@ -0,0 +1,406 @@
+/*
+ * Scaling report of one revision in the benchmark store
+ *
+ * Compile : gcc -g -Wall -o scaling_fit scaling_fit.c -lm
+ * Run : ./scaling_fit revision [plotFile]
+ *
+ * Every workload (n, m and fractions) with a serial record is a baseline. For every other
+ * variant measured on that workload the throughput at each thread count is turned into a
+ * speedup over the serial list and a parallel efficiency (speedup / threads).
+ *
+ * The relative capacity C(p) = X(p) / X(1) of a variant, against its own one thread
+ * throughput (or the serial one when it has none), is fitted with
+ *
+ *     Amdahl's Law                    C(p) = p / (1 + s (p - 1))
+ *     Universal Scalability Law       C(p) = p / (1 + s (p - 1) + k p (p - 1))
+ *
+ * by least squares on the linear form p / C(p) - 1 = s (p - 1) + k p (p - 1), with s the
+ * serial (contention) fraction, kept in [0, 1], and k the coherency (crosstalk) fraction,
+ * kept >= 0.
+ * With k > 0 the USL throughput peaks at p* = sqrt((1 - s) / k) threads.
+ *
+ * With plotFile a gnuplot script is written which plots the measured speedups and the
+ * USL curves of every variant to plotFile with ".png" appended.
+ *
+ * */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define RECORD_FILE "benchmarks.tsv"
+#define INITIAL_RECORDS 4096
+#define MAX_FIELD 64
+
+//Thread counts of one variant on one workload, and fitted variants of a report
+#define MAX_POINTS 64
+#define MAX_FITS 512
+
+//Record definition, one line of the benchmark store
+struct record_s {
+    char revision[MAX_FIELD];
+    char variant[MAX_FIELD];
+    int threads;
+    int n;
+    int m;
+    float mMember, mInsert, mDelete;
+    int samples;
+    double mean;
+    double std;
+};
+
+//Fit of one variant on one workload
+struct fit_s {
+    struct record_s *config;
+    int points;
+    int maxThreads;
+    double amdahlSerial;
+    double uslSerial;
+    double uslCoherency;
+    double rSquared;
+    double peakThreads;
+    double peakThroughput;
+};
+
+struct record_s *records = NULL;
+int noOfRecords = 0;
+int recordCapacity = 0;
+
+struct fit_s fits[MAX_FITS];
+int noOfFits = 0;
+
+char *revision = NULL;
+
+// Gnuplot script of the speedups, NULL for none
+char *plotFile = NULL;
+
+void validateInput(int argc, char *argv[]);
+
+void readRecords();
+
+int isSameWorkload(struct record_s *a, struct record_s *b);
+
+int isFirstOf(int index, char *variant);
+
+struct record_s *findLatest(char *variant, int threads, struct record_s *config);
+
+int collectPoints(char *variant, struct record_s *config, int *threads, double *throughput);
+
+void fitScaling(int points, int *threads, double *capacity, struct fit_s *fit);
+
+void writePlot(double *serialThroughput);
+
+int main(int argc, char *argv[]) {
+
+    //Retrieve and validate inputs
+    validateInput(argc, argv);
+
+    readRecords();
+
+    int i = 0, j = 0, k = 0;
+    int points = 0;
+    int threads[MAX_POINTS];
+    double throughput[MAX_POINTS], capacity[MAX_POINTS];
+    double serialThroughput[MAX_FITS];
+
+    printf("%-24s %8s %6s %6s %6s %7s %14s %9s %10s\n", "variant", "n", "member", "insert", "delete",
+           "threads", "ops/sec", "speedup", "efficiency");
+
+    for (i = 0; i < noOfRecords; i++) {
+        struct record_s *serial = NULL;
+        double serialX = 0.0;
+
+        //Only handle each serial baseline once, at its first appearance
+        if (!isFirstOf(i, "serial"))
+            continue;
+        serial = findLatest("serial", 1, &records[i]);
+        serialX = serial->mean > 0 ? serial->m / serial->mean : 0.0;
+        if (serialX <= 0)
+            continue;
+
+        //Every other variant measured on the same workload
+        for (j = 0; j < noOfRecords && noOfFits < MAX_FITS; j++) {
+            char *variant = records[j].variant;
+            double base = serialX;
+
+            if (strncmp(variant, "serial", 6) == 0 || !isSameWorkload(&records[j], serial) ||
+                !isFirstOf(j, variant))
+                continue;
+
+            points = collectPoints(variant, serial, threads, throughput);
+            for (k = 0; k < points; k++) {
+                double speedup = throughput[k] / serialX;
+
+                if (threads[k] == 1)
+                    base = throughput[k];
+                printf("%-24s %8d %6.3f %6.3f %6.3f %7d %14.0f %8.3fx %9.1f%%\n", variant, serial->n,
+                       serial->mMember, serial->mInsert, serial->mDelete, threads[k], throughput[k],
+                       speedup, 100 * speedup / threads[k]);
+            }
+            for (k = 0; k < points; k++)
+                capacity[k] = throughput[k] / base;
+
+            fits[noOfFits].config = &records[j];
+            fitScaling(points, threads, capacity, &fits[noOfFits]);
+            fits[noOfFits].peakThroughput *= base;
+            serialThroughput[noOfFits] = serialX;
+            noOfFits++;
+        }
+    }
+
+    //Fitted fractions and predicted peak of every variant
+    printf("\n%-24s %8s %6s %6s %6s %6s %9s %9s %10s %7s %14s %6s\n", "variant", "n", "member", "insert",
+           "delete", "points", "amdahl s", "usl s", "usl k", "peak p", "peak ops/sec", "R2");
+    for (i = 0; i < noOfFits; i++) {
+        struct fit_s *fit = &fits[i];
+        char peak[32];
+
+        if (fit->points < 3) {
+            printf("%-24s %8d %6.3f %6.3f %6.3f %6d   too few thread counts to fit\n", fit->config->variant,
+                   fit->config->n, fit->config->mMember, fit->config->mInsert, fit->config->mDelete, fit->points);
+            continue;
+        }
+
+        //Without a coherency term the USL never turns down
+        if (fit->peakThreads > 0)
+            snprintf(peak, sizeof(peak), "%.1f", fit->peakThreads);
+        else
+            snprintf(peak, sizeof(peak), "none");
+        printf("%-24s %8d %6.3f %6.3f %6.3f %6d %9.4f %9.4f %10.6f %7s %14.0f %6.3f\n", fit->config->variant,
+               fit->config->n, fit->config->mMember, fit->config->mInsert, fit->config->mDelete, fit->points,
+               fit->amdahlSerial, fit->uslSerial, fit->uslCoherency, peak, fit->peakThroughput, fit->rSquared);
+    }
+
+    if (plotFile != NULL)
+        writePlot(serialThroughput);
+
+    printf("\n%d variant workloads fitted for revision %s\n", noOfFits, revision);
+
+    return 0;
+}
+
+//Retrieve and validate the inputs
+void validateInput(int argc, char *argv[]) {
+
+    if (argc != 2 && argc != 3) {
+        printf("Enter the command with arguments revision and optionally plotFile\n");
+        exit(2);
+    }
+
+    revision = argv[1];
+    if (argc == 3)
+        plotFile = argv[2];
+}
+
+//Read the records of the revision from the whole benchmark store
+void readRecords() {
+    struct record_s r;
+    FILE *f = fopen(RECORD_FILE, "r");
+    if (f == NULL)
+    {
+        printf("Error occured while opening the file \n");
+        exit(2);
+    }
+
+    for (;;) {
+        int fields = fscanf(f, "%63s %63s %d %d %d %f %f %f %d %lf %lf", r.revision, r.variant,
+                            &r.threads, &r.n, &r.m, &r.mMember, &r.mInsert, &r.mDelete,
+                            &r.samples, &r.mean, &r.std);
+        if (fields != 11)
+            break;
+        if (strcmp(r.revision, revision) != 0)
+            continue;
+
+        if (noOfRecords == recordCapacity) {
+            recordCapacity = recordCapacity > 0 ? 2 * recordCapacity : INITIAL_RECORDS;
+            records = realloc(records, sizeof(struct record_s) * recordCapacity);
+            if (records == NULL) {
+                printf("Error occured while allocating the records \n");
+                exit(2);
+            }
+        }
+        records[noOfRecords++] = r;
+    }
+
+    fclose(f);
+}
+
+//Check whether two records ran the same workload, whatever their variant and threads
+int isSameWorkload(struct record_s *a, struct record_s *b) {
+    return a->n == b->n && a->m == b->m && a->mMember == b->mMember && a->mInsert == b->mInsert &&
+           a->mDelete == b->mDelete;
+}
+
+//Check whether records[index] is the first record of variant on its workload
+int isFirstOf(int index, char *variant) {
+    int i;
+
+    if (strcmp(records[index].variant, variant) != 0)
+        return 0;
+    for (i = 0; i < index; i++) {
+        if (strcmp(records[i].variant, variant) == 0 && isSameWorkload(&records[i], &records[index]))
+            return 0;
+    }
+    return 1;
+}
+
+//Find the most recent record of a variant at a thread count on the workload of config
+struct record_s *findLatest(char *variant, int threads, struct record_s *config) {
+    int i;
+
+    for (i = noOfRecords - 1; i >= 0; i--) {
+        if (strcmp(records[i].variant, variant) == 0 && records[i].threads == threads &&
+            isSameWorkload(&records[i], config))
+            return &records[i];
+    }
+    return NULL;
+}
+
+//Throughput of a variant at every thread count measured on the workload, by increasing threads
+int collectPoints(char *variant, struct record_s *config, int *threads, double *throughput) {
+    int i, j, points = 0;
+    struct record_s *r;
+
+    for (i = 0; i < noOfRecords; i++) {
+        if (strcmp(records[i].variant, variant) != 0 || !isSameWorkload(&records[i], config) ||
+            records[i].mean <= 0)
+            continue;
+        for (j = 0; j < points && threads[j] != records[i].threads; j++)
+            ;
+        if (j < points || points == MAX_POINTS)
+            continue;
+
+        r = findLatest(variant, records[i].threads, config);
+        for (j = points; j > 0 && threads[j - 1] > r->threads; j--) {
+            threads[j] = threads[j - 1];
+            throughput[j] = throughput[j - 1];
+        }
+        threads[j] = r->threads;
+        throughput[j] = r->m / r->mean;
+        points++;
+    }
+    return points;
+}
+
+//Least squares fit of Amdahl's Law and the USL to the relative capacities
+void fitScaling(int points, int *threads, double *capacity, struct fit_s *fit) {
+    double sxx = 0, sxz = 0, szz = 0, sxy = 0, szy = 0;
+    double x, y, z, det, s, k, predicted, mean = 0, residual = 0, total = 0;
+    int i;
+
+    fit->points = points;
+    fit->maxThreads = points > 0 ? threads[points - 1] : 0;
+
+    //p / C(p) - 1 = s x + k z with x = p - 1 and z = p (p - 1)
+    for (i = 0; i < points; i++) {
+        x = threads[i] - 1;
+        z = threads[i] * x;
+        y = threads[i] / capacity[i] - 1;
+        sxx += x * x;
+        sxz += x * z;
+        szz += z * z;
+        sxy += x * y;
+        szy += z * y;
+    }
+
+    fit->amdahlSerial = sxx > 0 ? sxy / sxx : 0.0;
+    if (fit->amdahlSerial < 0)
+        fit->amdahlSerial = 0.0;
+    else if (fit->amdahlSerial > 1)
+        fit->amdahlSerial = 1.0;
+
+    det = sxx * szz - sxz * sxz;
+    s = det > 0 ? (sxy * szz - szy * sxz) / det : 0.0;
+    k = det > 0 ? (szy * sxx - sxy * sxz) / det : 0.0;
+
+    //Keeping s in [0, 1] and k >= 0, refitting k alone when s is clamped
+    //(throughput falling below the one thread throughput drives s above 1)
+    if (k < 0) {
+        k = 0.0;
+        s = fit->amdahlSerial;
+    }
+    if (s < 0 || s > 1) {
+        s = s < 0 ? 0.0 : 1.0;
+        k = szz > 0 ? (szy - s * sxz) / szz : 0.0;
+        if (k < 0)
+            k = 0.0;
+    }
+    fit->uslSerial = s;
+    fit->uslCoherency = k;
+
+    //Goodness of the USL fit on the capacities
+    for (i = 0; i < points; i++)
+        mean += capacity[i] / points;
+    for (i = 0; i < points; i++) {
+        predicted = threads[i] / (1 + s * (threads[i] - 1) + k * threads[i] * (threads[i] - 1));
+        residual += (capacity[i] - predicted) * (capacity[i] - predicted);
+        total += (capacity[i] - mean) * (capacity[i] - mean);
+    }
+    fit->rSquared = total > 0 ? 1 - residual / total : 1.0;
+
+    //Peak of the USL, a relative capacity for now
+    if (k > 0) {
+        fit->peakThreads = sqrt((1 - s) / k) > 1 ? sqrt((1 - s) / k) : 1.0;
+        x = fit->peakThreads;
+    } else {
+        fit->peakThreads = 0.0;
+        x = fit->maxThreads;
+    }
+    fit->peakThroughput = x / (1 + s * (x - 1) + k * x * (x - 1));
+}
+
+//Gnuplot script of the measured speedups and the USL curve of every fitted variant
+void writePlot(double *serialThroughput) {
+    int i, k, points, maxThreads = 1;
+    int threads[MAX_POINTS];
+    double throughput[MAX_POINTS];
+    double base;
+    FILE *f = fopen(plotFile, "w");
+    if (f == NULL)
+    {
+        printf("Error occured while opening the file \n");
+        exit(2);
+    }
+
+    fprintf(f, "set terminal pngcairo size 1400,900\n");
+    fprintf(f, "set output '%s.png'\n", plotFile);
+    fprintf(f, "set xlabel 'threads'\nset ylabel 'speedup over serial'\n");
+    fprintf(f, "set logscale x 2\nset grid\nset key outside right\n");
+
+    for (i = 0; i < noOfFits; i++) {
+        struct record_s *config = fits[i].config;
+
+        points = collectPoints(config->variant, config, threads, throughput);
+        fprintf(f, "$points%d << EOD\n", i);
+        for (k = 0; k < points; k++)
+            fprintf(f, "%d %f\n", threads[k], throughput[k] / serialThroughput[i]);
+        fprintf(f, "EOD\n");
+
+        //The curve is the capacity scaled by the one thread throughput of the variant
+        base = throughput[0] / serialThroughput[i];
+        if (threads[0] != 1)
+            base = 1.0;
+        fprintf(f, "usl%d(p) = %f * p / (1 + %f * (p - 1) + %f * p * (p - 1))\n", i, base,
+                fits[i].uslSerial, fits[i].uslCoherency);
+    }
+
+    if (noOfFits == 0) {
+        fclose(f);
+        return;
+    }
+    for (i = 0; i < noOfFits; i++)
+        if (fits[i].maxThreads > maxThreads)
+            maxThreads = fits[i].maxThreads;
+
+    fprintf(f, "plot [1:%d] ", 2 * maxThreads);
+    for (i = 0; i < noOfFits; i++) {
+        struct record_s *config = fits[i].config;
+
+        fprintf(f, "%s$points%d with points pt 7 lc %d title '%s n=%d %.2f/%.2f/%.2f', usl%d(x) with lines lc %d notitle",
+                i > 0 ? ", \\\n    " : "", i, i + 1, config->variant, config->n, config->mMember,
+                config->mInsert, config->mDelete, i, i + 1);
+    }
+    fprintf(f, "\n");
+
+    fclose(f);
+}
@@ -3,16 +3,26 @@
  *
  * Compile : gcc -g -Wall -o serial_linked_list serial_linked_list.c
  * Run : ./serial_linked_list noOfSamples n m mMember mInsert mDelete
+ *       [FINGER_MODE=] [LOCALITY=] in the environment (see "env_options.h")
  *
  * */
  
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h> 
+#include <string.h>
 #include <math.h>
 
+#include "memory_stats.h"
+#include "sample_clock.h"
+#include "sample_stats.h"
+#include "env_options.h"
+
 #define MAX_RANDOM 65535
 
+//The single thread keeps one finger
+#define MAX_THREADS 1
+
 struct list_node_s** head;
 
 // Number of samples
@@ -21,21 +31,23 @@ int noOfSamples = 0;
 // Number of nodes in the linked list
 int n = 0;
 
+// Keys are drawn from [0, keyRange), widened beyond MAX_RANDOM for large n
+int keyRange = MAX_RANDOM;
+
 // Number of random operations in the linked list
 int m = 0;
 
 // Fractions of each operation
 float mInsert, mDelete, mMember;
 
-//Minimum number of samples needed for confidence and accuracy
-float minNoOfSamples;  
-
 //Node definition
 struct list_node_s {
     int data;
     struct list_node_s *next;
 };
 
+#include "finger.h"
+
 int Insert(int value, struct list_node_s **head_pp);
 
 int Delete(int value, struct list_node_s **head_pp);
@@ -46,10 +58,14 @@ void validateInput(int argc, char *argv[]);
 
 double calcTime(clock_t startTime, clock_t endTime);
 
-double findStd(double timeArray[], int noOfSamples, double mean);
+int compareNodes(const void *a, const void *b);
 
 void populate(int n, struct list_node_s **head_p);
 
+void destroy(struct list_node_s **head_pp);
+
+void measureMemory(struct list_node_s *head_p);
+
 void writeOutput(double mean, double std) ;
 
 int main(int argc, char *argv[]) {
@@ -63,20 +79,17 @@ int main(int argc, char *argv[]) {
 	//Time spend for a particular sample
 	double sampleTime = 0;
 	
-	//Total time spent for all the samples
-	double totalTime = 0;
-	
 	//Mean of times of all the samples
 	double mean = 0;
 	
 	//Standard deviation of all the samples
 	double std = 0;  
 	
-	//Time values of all the samples
-	double timeArray[noOfSamples]; 
-	
 	//Time keeping variables 
     clock_t startTime, endTime;
+	
+	//Wall time at which sampling started, used for the sampling time cap
+	time_t samplingStart = time(NULL);
     
     //Random seed for random values
 	srand(time(NULL));
@@ -84,6 +97,7 @@ int main(int argc, char *argv[]) {
 	for(sampleNumber = 0; sampleNumber < noOfSamples; sampleNumber++){
 		
 		head = malloc(sizeof(struct list_node_s));
+		resetPeakRss();
 		
 		//Populating linked list with random values	
 		populate(n,head);
@@ -100,12 +114,15 @@ int main(int argc, char *argv[]) {
 		float noOfMember = mMember * m;
 		
 		//Recording time at operations start
+		fingerBegin(1);
+		fingerThreadStart(0);
 		startTime = clock();
+		sampleClockStart();
 		
 		while (totalExecuted < m) {
 			
 			//Random number to be used in the operation
-			int randomNumber = rand() % MAX_RANDOM;
+			int randomNumber = fingerKey(keyRange);
 			
 			//Select the operation randomly
 			int randomOperation = rand() % 3;
@@ -131,23 +148,41 @@ int main(int argc, char *argv[]) {
 		
 		//Recording the time at operation ends
 		endTime = clock();
+		sampleClockStop();
+		fingerEnd();
+		finger = NULL;
 		
 		//Deallocate the memory of this sample's linked list
-		//free(head);		
+		measureMemory(*head);
+		destroy(head);
+		free(head);
 		
-		sampleTime = calcTime(startTime, endTime);
-		timeArray[sampleNumber] = sampleTime;
-		totalTime = totalTime + sampleTime;
+		sampleTime = sampleClockTime(calcTime(startTime, endTime));
+		addSample(sampleTime);
 		//printf("Average of sample %d  = %f\n",sampleNumber,sampleTime);		
+
+		//Stop as soon as the confidence target is met
+		if (isConfidenceReached())
+			break;
+
+		//Stop if the sampling time cap is exceeded
+		if (difftime(time(NULL), samplingStart) > MAX_SAMPLING_TIME)
+			break;
 	}
 	
 	//Calculate mean for all the samples
-	mean = totalTime / noOfSamples;
+	mean = runningMean;
 	
 	//Calculate Standard deviation for all the samples
-	std = findStd(timeArray, noOfSamples, mean);
+	std = findStd();
 	
 	writeOutput(mean, std);
+	//Fingers and a local workload make a configuration of their own
+	char variant[64];
+	snprintf(variant, sizeof(variant), "serial%s", fingerMode == FINGER_ON ? "-finger" : "");
+	if (locality > 0)
+		snprintf(variant + strlen(variant), sizeof(variant) - strlen(variant), "-local%.2f", locality);
+	writeRecord(variant, 1, n, m, mMember, mInsert, mDelete, mean, std);
 	//printf("Average time spent = %f\n",mean);
 	//printf("Standard Deviation = %f\n",(std));
   
@@ -157,11 +192,18 @@ int main(int argc, char *argv[]) {
 
 
 //Linked List Membership function
+//The traversal starts from the finger when it is before value
 int Member(int value, struct list_node_s* head_p) {
-    struct list_node_s* current_p = head_p;
+    struct list_node_s* pred_p = fingerStart(value);
+    struct list_node_s* current_p = pred_p != NULL ? pred_p->next : head_p;
+    long hops = 0;
 
-    while (current_p != NULL && current_p->data < value)
+    while (current_p != NULL && current_p->data < value) {
+        pred_p = current_p;
         current_p = current_p->next;
+        hops++;
+    }
+    fingerDone(pred_p, hops);
 
     if (current_p == NULL || current_p->data > value) {
         return 0;
@@ -172,13 +214,15 @@ int Member(int value, struct list_node_s* head_p) {
 
 //Linked List Insertion function
 int Insert(int value, struct list_node_s** head_pp) {
-    struct list_node_s* curr_p = *head_pp;
-    struct list_node_s* pred_p = NULL;
+    struct list_node_s* pred_p = fingerStart(value);
+    struct list_node_s* curr_p = pred_p != NULL ? pred_p->next : *head_pp;
     struct list_node_s* temp_p = NULL;
+    long hops = 0;
 
     while (curr_p != NULL && curr_p->data < value) {
         pred_p = curr_p;
         curr_p = curr_p->next;
+        hops++;
     }
 
     if (curr_p == NULL || curr_p->data > value) {
@@ -191,24 +235,31 @@ int Insert(int value, struct list_node_s** head_pp) {
         else
             pred_p->next = temp_p;
 
+        fingerDone(temp_p, hops);
         return 1;
     }
-    else
+    else {
+        fingerDone(pred_p, hops);
         return 0;
+    }
 }
 
 
 //Linked List Deletion function
 int Delete(int value, struct list_node_s** head_pp) {
-    struct list_node_s* curr_p = *head_pp;
-    struct list_node_s* pred_p = NULL;
+    struct list_node_s* pred_p = fingerStart(value);
+    struct list_node_s* curr_p = pred_p != NULL ? pred_p->next : *head_pp;
+    long hops = 0;
 
     while (curr_p != NULL && curr_p->data < value) {
         pred_p = curr_p;
         curr_p = curr_p->next;
+        hops++;
     }
+    fingerDone(pred_p, hops);
 
     if (curr_p != NULL && curr_p->data == value) {
+        fingerRelease(curr_p);
         if (pred_p == NULL) {
             *head_pp = curr_p->next;
             free(curr_p);
@@ -223,30 +274,74 @@ int Delete(int value, struct list_node_s** head_pp) {
         return 0;
 }
 
+//Comparison of two nodes by their keys, used to link the populated list
+int compareNodes(const void *a, const void *b) {
+  int x = (*(struct list_node_s * const *) a)->data;
+  int y = (*(struct list_node_s * const *) b)->data;
+  return (x > y) - (x < y);
+}
+
 //Linked list population function
+//Nodes are allocated in random key order, as repeated Insert calls would do, but
+//linked in a single pass so that large lists do not take quadratic time to build
 void populate(int n, struct list_node_s** head_p)
 {
   int num,i;
-  int inserted;
-  *head_p = malloc(sizeof(struct list_node_s));
+  char *used = calloc(keyRange, sizeof(char));
+  struct list_node_s **nodes = malloc(sizeof(struct list_node_s *) * n);
+
   for(i=0; i<n; ){
-    num = rand() % MAX_RANDOM;
-    if(i==0){
-      (*head_p)->data = num;
-      i++;
-    }else
-      inserted = Insert(num, head_p);
-      if(inserted == 1){
-        i++;
-      }
-    }
+    num = rand() % keyRange;
+    if(used[num])
+      continue;
+    used[num] = 1;
+    nodes[i] = malloc(sizeof(struct list_node_s));
+    nodes[i]->data = num;
+    i++;
+  }
+
+  qsort(nodes, n, sizeof(struct list_node_s *), compareNodes);
+  for(i=0; i<n-1; i++)
+    nodes[i]->next = nodes[i+1];
+  nodes[n-1]->next = NULL;
+  *head_p = nodes[0];
+
+  free(nodes);
+  free(used);
+}
+
+//Free every node of the list, leaving it empty
+void destroy(struct list_node_s **head_pp) {
+  struct list_node_s *curr_p = *head_pp;
+  struct list_node_s *next_p;
+
+  while (curr_p != NULL) {
+    next_p = curr_p->next;
+    free(curr_p);
+    curr_p = next_p;
+  }
+  *head_pp = NULL;
+}
+
+//Record the memory footprint of the list at the end of a sample
+//Deleted nodes are freed at once, so nothing is ever retired
+void measureMemory(struct list_node_s *head_p) {
+  struct list_node_s *curr_p;
+  long live = 0;
+  double allocated = 0.0;
+
+  for (curr_p = head_p; curr_p != NULL; curr_p = curr_p->next) {
+    live++;
+    allocated += allocatedSize(curr_p);
+  }
+  recordMemory(live, (double) live * sizeof(struct list_node_s), allocated, 0.0);
 }
 
 //Retrieve and validate the inputs
 void validateInput(int argc, char *argv[]) {
 		
     if (argc != 7) {
-        printf("Enter the command with arguments noOfSamples, n, m, mMember, mInsert and mDelete\n");
+        printf("Enter the command with arguments noOfSamples, n, m, mMember, mInsert, mDelete\n");
         exit(0);
     }
     
@@ -258,6 +353,8 @@ void validateInput(int argc, char *argv[]) {
     mMember = (float) atof(argv[4]);
     mInsert = (float) atof(argv[5]);
     mDelete = (float) atof(argv[6]);
+    fingerMode = envInt("FINGER_MODE", fingerMode);
+    locality = envDouble("LOCALITY", locality);
 
     //Input validation
 	if (noOfSamples <= 0){
@@ -273,7 +370,17 @@ void validateInput(int argc, char *argv[]) {
 	}else if (mMember + mInsert + mDelete != 1.0){
 		printf("Invalid combination of fractions (Total = 1.0)\n");
 		exit(0);
+	}else if (fingerMode < FINGER_OFF || fingerMode > FINGER_ON){
+		printf("Invalid FINGER_MODE (0 = off, 1 = on)\n");
+		exit(0);
+	}else if (locality < 0 || locality > 1){
+		printf("Invalid LOCALITY (0 <= LOCALITY <= 1)\n");
+		exit(0);
 	}
+
+	//Keep the list at most half full of the key range
+	if (n > MAX_RANDOM / 2)
+		keyRange = 2 * n;
 }
 
 //Calculating time between operation start and end
@@ -281,26 +388,6 @@ double calcTime(clock_t startTime, clock_t endTime) {
     return (double) (endTime - startTime) / CLOCKS_PER_SEC;
 }
 
-//Standard Deviation calculating function
-double findStd(double timeArray[], int noOfSamples, double mean){
-  int i;
-  float std=0;
-  float temp=0.0;
-  
-  for(i=0; i<noOfSamples; i++){
-    timeArray[i] -= mean;
-    temp = timeArray[i]*timeArray[i];
-    std += temp;
-  }
-  std = std/noOfSamples;
-  std = sqrt(std);
-  
-  minNoOfSamples = pow((100*1.96*std)/(5*mean),2);
-  //printf("Minimum no. of samples needed = %f\n", minNoOfSamples);
-  
-  return std;
-}
-
 void writeOutput(double mean, double std) {
 	FILE *f = fopen("results.txt", "a"); 
 	if (f == NULL)
@@ -310,15 +397,22 @@ void writeOutput(double mean, double std) {
 	}
 	
 	fprintf(f,"\n === Serial === \n\n"); 
+	fprintf(f,"Number of Nodes = %d\n", n);
+	fprintf(f,"Number of Operations = %d\n", m);
 	fprintf(f,"Member Fraction= %.2f\n", mMember);  
 	fprintf(f,"Insert Fraction = %.3f\n", mInsert);  
 	fprintf(f,"Delete Fraction = %.3f\n", mDelete); 
-	fprintf(f,"Number of Samples = %d\n", noOfSamples);   
+	fprintf(f,"Max Number of Samples = %d\n", noOfSamples);
+	fprintf(f,"Number of Samples = %d\n", acceptedSamples);
+	fprintf(f,"Rejected Outliers = %d\n", rejectedSamples);
 	fprintf(f,"Min number of samples needed = %f\n", minNoOfSamples);  
 	fprintf(f,"Mean = %f\n", mean);  
-	fprintf(f,"Standard Deviation = %f\n", std);             
+	fprintf(f,"Standard Deviation = %f\n", std);
+	fprintf(f,"Throughput (ops/sec) = %f\n", mean > 0 ? m / mean : 0.0);
+	fprintf(f,"Confidence Interval (95%%) = +/- %f (%.2f%% of mean)\n", 1.96*std/sqrt(acceptedSamples), mean > 0 ? 100*1.96*std/sqrt(acceptedSamples)/mean : 0.0);
+	writeMemoryStats(f);
+	writeFingerStats(f);
 	fprintf(f,"________________________________________ \n\n");                   
 	
 	fclose(f); 
 }
-
@@ -0,0 +1,360 @@
+/*
+ * Load generator for the set server (set_server.c)
+ *
+ * Every connection runs in its own thread. In closed-loop mode (rate = 0) a connection
+ * keeps pipelineDepth requests outstanding and latency is measured from the moment a
+ * request is sent. In open-loop mode requests are issued at a constant total rate of
+ * rate requests per second regardless of the responses, and latency is measured from
+ * the intended send time, so server stalls are not hidden by a slower request stream.
+ * The open-loop socket is non-blocking and responses are read while requests wait to be
+ * written: the server stops reading a connection whose responses are not drained, so a
+ * blocking write would deadlock in overload.
+ *
+ * Compile : gcc -g -Wall -o set_client set_client.c -lpthread
+ * Run : ./set_client socketPath noOfConnections m mMember mInsert mDelete pipelineDepth [rate]
+ *
+ * */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "set_protocol.h"
+
+#define MAX_CONNECTIONS 1024
+#define MAX_RANDOM 65535
+#define MAX_PIPELINE 1024
+
+// Path of the server socket
+char *socketPath = NULL;
+
+// Number of connections, each driven by one thread
+int noOfConnections = 0;
+
+// Number of requests over all the connections
+int m = 0;
+
+// Fractions of each operation
+float mInsert = 0.0, mDelete = 0.0, mMember = 0.0;
+
+// Requests kept outstanding per connection in closed-loop mode
+int pipelineDepth = 1;
+
+// Total request rate (requests/sec) in open-loop mode, 0 for closed-loop
+double rate = 0.0;
+
+//Latencies (seconds) of all the requests, each connection fills its own range
+double *latencies;
+
+//State of one connection
+struct connection_s {
+    int id;
+    int fd;
+    int noOfRequests;
+    double *latencies;
+    unsigned int seed;
+};
+
+void validateInput(int argc, char *argv[]);
+
+double now();
+
+int connectServer();
+
+void writeAll(int fd, char *buffer, int length);
+
+struct set_request_s nextRequest(struct connection_s *connection_p);
+
+void *closedLoopOperation(void *connection);
+
+void *openLoopOperation(void *connection);
+
+int compareLatencies(const void *a, const void *b);
+
+double percentile(double fraction, int count);
+
+void writeOutput(double throughput, int count);
+
+int main(int argc, char *argv[]) {
+
+    //Retrieve and validate inputs
+    validateInput(argc, argv);
+
+    pthread_t *threadHandlers = malloc(sizeof(pthread_t) * noOfConnections);
+    struct connection_s *connections = malloc(sizeof(struct connection_s) * noOfConnections);
+    double startTime, endTime;
+    int i, offset = 0;
+
+    latencies = malloc(sizeof(double) * m);
+
+    for (i = 0; i < noOfConnections; i++) {
+        connections[i].id = i;
+        connections[i].fd = connectServer();
+        connections[i].noOfRequests = m / noOfConnections + (m % noOfConnections > i ? 1 : 0);
+        connections[i].latencies = latencies + offset;
+        connections[i].seed = time(NULL) ^ (i << 16);
+        offset += connections[i].noOfRequests;
+    }
+
+    startTime = now();
+    for (i = 0; i < noOfConnections; i++)
+        pthread_create(&threadHandlers[i], NULL, rate > 0 ? openLoopOperation : closedLoopOperation,
+                       (void *) &connections[i]);
+    for (i = 0; i < noOfConnections; i++)
+        pthread_join(threadHandlers[i], NULL);
+    endTime = now();
+
+    for (i = 0; i < noOfConnections; i++)
+        close(connections[i].fd);
+
+    qsort(latencies, m, sizeof(double), compareLatencies);
+    writeOutput(m / (endTime - startTime), m);
+
+    free(latencies);
+    free(connections);
+    free(threadHandlers);
+    return 0;
+}
+
+//Retrieve and validate the inputs
+void validateInput(int argc, char *argv[]) {
+
+    if (argc != 8 && argc != 9) {
+        printf("Enter the command with arguments socketPath, noOfConnections, m, mMember, mInsert, mDelete, pipelineDepth and optionally rate\n");
+        exit(0);
+    }
+
+    //Input retrieval
+    socketPath = argv[1];
+    noOfConnections = (int) strtol(argv[2], (char**) NULL, 10);
+    m = (int) strtol(argv[3], (char**) NULL, 10);
+    mMember = (float) atof(argv[4]);
+    mInsert = (float) atof(argv[5]);
+    mDelete = (float) atof(argv[6]);
+    pipelineDepth = (int) strtol(argv[7], (char**) NULL, 10);
+    if (argc == 9)
+        rate = atof(argv[8]);
+
+    //Input validation
+    if (noOfConnections <= 0 || noOfConnections > MAX_CONNECTIONS) {
+        printf("Invalid no. of Connections (0 < noOfConnections < %d)\n", MAX_CONNECTIONS);
+        exit(0);
+    } else if (m < noOfConnections) {
+        printf("Invalid input for m (m >= noOfConnections)\n");
+        exit(0);
+    } else if (mMember + mInsert + mDelete != 1.0) {
+        printf("Invalid combination of fractions (Total = 1.0)\n");
+        exit(0);
+    } else if (pipelineDepth <= 0 || pipelineDepth > MAX_PIPELINE) {
+        printf("Invalid pipelineDepth (0 < pipelineDepth <= %d)\n", MAX_PIPELINE);
+        exit(0);
+    } else if (rate < 0) {
+        printf("Invalid rate (rate >= 0)\n");
+        exit(0);
+    }
+}
+
+double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int connectServer() {
+    struct sockaddr_un address;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath, sizeof(address.sun_path) - 1);
+    if (fd < 0 || connect(fd, (struct sockaddr *) &address, sizeof(address)) != 0) {
+        printf("Error occured while connecting to %s \n", socketPath);
+        exit(1);
+    }
+    return fd;
+}
+
+void writeAll(int fd, char *buffer, int length) {
+    while (length > 0) {
+        ssize_t sent = write(fd, buffer, length);
+        if (sent < 0) {
+            if (errno == EINTR)
+                continue;
+            printf("Error occured while sending requests \n");
+            exit(1);
+        }
+        buffer += sent;
+        length -= sent;
+    }
+}
+
+//Random request following the operation fractions
+struct set_request_s nextRequest(struct connection_s *connection_p) {
+    struct set_request_s request;
+    double selector = (double) rand_r(&connection_p->seed) / RAND_MAX;
+
+    if (selector < mMember)
+        request.op = SET_MEMBER;
+    else if (selector < mMember + mInsert)
+        request.op = SET_INSERT;
+    else
+        request.op = SET_DELETE;
+    request.key = rand_r(&connection_p->seed) % MAX_RANDOM;
+    return request;
+}
+
+//Closed loop, pipelineDepth requests outstanding at any time
+void *closedLoopOperation(void *connection) {
+    struct connection_s *connection_p = connection;
+    struct set_request_s requests[MAX_PIPELINE];
+    char responses[MAX_PIPELINE];
+    double *sendTimes = malloc(sizeof(double) * connection_p->noOfRequests);
+    int sent = 0, received = 0;
+    int i, count;
+
+    while (received < connection_p->noOfRequests) {
+        count = pipelineDepth - (sent - received);
+        if (count > connection_p->noOfRequests - sent)
+            count = connection_p->noOfRequests - sent;
+
+        if (count > 0) {
+            double sendTime = now();
+            for (i = 0; i < count; i++) {
+                requests[i] = nextRequest(connection_p);
+                sendTimes[sent + i] = sendTime;
+            }
+            writeAll(connection_p->fd, (char *) requests, count * REQUEST_SIZE);
+            sent += count;
+        }
+
+        ssize_t length = read(connection_p->fd, responses, sent - received);
+        if (length <= 0) {
+            printf("Error occured while receiving responses \n");
+            exit(1);
+        }
+        double receiveTime = now();
+        for (i = 0; i < length; i++, received++)
+            connection_p->latencies[received] = receiveTime - sendTimes[received];
+    }
+
+    free(sendTimes);
+    return NULL;
+}
+
+//Open loop, requests are sent at their intended times whether or not responses arrived
+void *openLoopOperation(void *connection) {
+    struct connection_s *connection_p = connection;
+    struct set_request_s requests[MAX_PIPELINE];
+    char responses[MAX_PIPELINE];
+    double interval = noOfConnections / rate;
+    double startTime = now();
+    int sent = 0, received = 0;
+    int i, count;
+    //Bytes of requests still to be written
+    char *pending_p = (char *) requests;
+    int pendingLength = 0;
+
+    fcntl(connection_p->fd, F_SETFL, fcntl(connection_p->fd, F_GETFL) | O_NONBLOCK);
+
+    while (received < connection_p->noOfRequests) {
+        double currentTime = now();
+
+        //Queue every request whose intended time has passed, once the previous ones are written
+        if (pendingLength == 0) {
+            for (count = 0; sent + count < connection_p->noOfRequests && count < MAX_PIPELINE &&
+                            startTime + (sent + count) * interval <= currentTime; count++)
+                requests[count] = nextRequest(connection_p);
+            pending_p = (char *) requests;
+            pendingLength = count * REQUEST_SIZE;
+            sent += count;
+        }
+
+        //Wait for responses until the next request is due, or for room to write as nothing
+        //more can be queued until the pending requests are written
+        double wait = sent < connection_p->noOfRequests ? startTime + sent * interval - now() : 0.1;
+        struct pollfd pollFd = {connection_p->fd, pendingLength > 0 ? POLLIN | POLLOUT : POLLIN, 0};
+        struct timespec timeout;
+        if (wait < 0)
+            wait = 0;
+        timeout.tv_sec = (time_t) wait;
+        timeout.tv_nsec = (long) ((wait - timeout.tv_sec) * 1e9);
+        if (ppoll(&pollFd, 1, pendingLength > 0 ? NULL : &timeout, NULL) <= 0)
+            continue;
+
+        if (pollFd.revents & POLLOUT) {
+            ssize_t length = write(connection_p->fd, pending_p, pendingLength);
+            if (length < 0 && errno != EAGAIN && errno != EINTR) {
+                printf("Error occured while sending requests \n");
+                exit(1);
+            }
+            if (length > 0) {
+                pending_p += length;
+                pendingLength -= length;
+            }
+        }
+
+        if (!(pollFd.revents & (POLLIN | POLLHUP | POLLERR)) || received == sent)
+            continue;
+
+        ssize_t length = read(connection_p->fd, responses, sent - received < MAX_PIPELINE ? sent - received : MAX_PIPELINE);
+        if (length < 0 && (errno == EAGAIN || errno == EINTR))
+            continue;
+        if (length <= 0) {
+            printf("Error occured while receiving responses \n");
+            exit(1);
+        }
+        double receiveTime = now();
+        for (i = 0; i < length; i++, received++)
+            connection_p->latencies[received] = receiveTime - (startTime + received * interval);
+    }
+
+    return NULL;
+}
+
+int compareLatencies(const void *a, const void *b) {
+    double x = *(const double *) a, y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+//Latency percentile in microseconds, latencies must be sorted
+double percentile(double fraction, int count) {
+    int index = (int) (fraction * count);
+    if (index >= count)
+        index = count - 1;
+    return latencies[index] * 1e6;
+}
+
+void writeOutput(double throughput, int count) {
+	FILE *f = fopen("results.txt", "a");
+	if (f == NULL)
+	{
+		printf("Error occured while opening the file \n");
+		exit(1);
+	}
+
+	fprintf(f,"\n === Set Server Client === \n\n");
+	if (rate > 0)
+		fprintf(f,"Mode = open loop, offered rate = %.0f requests/sec\n", rate);
+	else
+		fprintf(f,"Mode = closed loop, pipeline depth = %d\n", pipelineDepth);
+	fprintf(f,"Number of Connections = %d\n", noOfConnections);
+	fprintf(f,"Number of Requests = %d\n", count);
+	fprintf(f,"Member Fraction= %.2f\n", mMember);
+	fprintf(f,"Insert Fraction = %.3f\n", mInsert);
+	fprintf(f,"Delete Fraction = %.3f\n", mDelete);
+	fprintf(f,"Throughput (requests/sec) = %f\n", throughput);
+	fprintf(f,"Latency (us) p50 = %.1f, p90 = %.1f, p99 = %.1f, p99.9 = %.1f, max = %.1f\n",
+			percentile(0.5, count), percentile(0.9, count), percentile(0.99, count),
+			percentile(0.999, count), percentile(1.0, count));
+	fprintf(f,"________________________________________ \n\n");
+
+	fclose(f);
+}
@@ -0,0 +1,28 @@
+/*
+ * Binary protocol of the set server (set_server.c) and its load generator (set_client.c)
+ *
+ * A client sends fixed size requests over a Unix domain stream socket and may pipeline
+ * any number of them. The server answers every request with one byte, in request order:
+ * 1 if the key was found / inserted / deleted and 0 otherwise.
+ *
+ * */
+#ifndef SET_PROTOCOL_H
+#define SET_PROTOCOL_H
+
+#include <stdint.h>
+
+//Request operations
+#define SET_MEMBER 0
+#define SET_INSERT 1
+#define SET_DELETE 2
+
+//Request definition, both ends run on the same host so fields are in host byte order
+struct set_request_s {
+    uint32_t op;
+    int32_t key;
+};
+
+#define REQUEST_SIZE ((int) sizeof(struct set_request_s))
+#define RESPONSE_SIZE 1
+
+#endif
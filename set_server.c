@@ -0,0 +1,427 @@
+/*
+ * Set server : the read write lock list served over a Unix domain socket
+ *
+ * Connections are spread over noOfThreads worker threads, each running its own epoll
+ * loop. Requests are pipelined (see set_protocol.h) and every read of a connection is
+ * processed as a batch : consecutive Member requests share one read lock acquisition
+ * and consecutive Insert/Delete requests share one write lock acquisition, so the
+ * responses stay in request order.
+ *
+ * Compile : gcc -g -Wall -o set_server set_server.c -lpthread
+ * Run : ./set_server socketPath noOfThreads n
+ *
+ * The server runs until it receives SIGINT or SIGTERM, then prints its batching statistics.
+ * The signals are blocked in the workers, so only the main thread takes them, and the
+ * handler writes to a self-pipe which the main thread's epoll loop watches next to the
+ * listening socket : a signal arriving just before the wait still wakes it up.
+ *
+ * */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "set_protocol.h"
+
+#define MAX_THREADS 1024
+#define MAX_RANDOM 65535
+#define MAX_EVENTS 64
+
+//Requests buffered per connection, also the largest batch
+#define MAX_BATCH 1024
+
+// Path of the listening socket
+char *socketPath = NULL;
+
+// Number of worker threads
+int noOfThreads = 0;
+
+// Number of nodes in the linked list
+int n = 0;
+
+// Set on SIGINT or SIGTERM
+volatile sig_atomic_t isStopping = 0;
+
+//Self-pipe written by the signal handler, read end watched by the main thread
+int stopPipe[2] = {-1, -1};
+
+//Batching statistics, summed over all the workers
+unsigned long totalRequests = 0;
+unsigned long totalLockAcquisitions = 0;
+unsigned long totalBatches = 0;
+
+struct list_node_s* head = NULL;
+pthread_rwlock_t rwlock;
+
+//Epoll instances of the workers
+int *workerEpoll;
+
+//Node definition
+struct list_node_s {
+    int data;
+    struct list_node_s *next;
+};
+
+//Connection definition, requests not yet processed and responses not yet sent
+struct connection_s {
+    int fd;
+    char in[MAX_BATCH * REQUEST_SIZE];
+    int inLength;
+    char out[MAX_BATCH * RESPONSE_SIZE];
+    int outLength;
+    int outSent;
+};
+
+int Insert(int value, struct list_node_s **head_pp);
+
+int Delete(int value, struct list_node_s **head_pp);
+
+int Member(int value, struct list_node_s *head_p);
+
+void validateInput(int argc, char *argv[]);
+
+void populate(int n, struct list_node_s** head_pp);
+
+int processBatch(struct connection_s *connection_p, unsigned long *lockAcquisitions);
+
+int flushResponses(struct connection_s *connection_p);
+
+void closeConnection(int epollFd, struct connection_s *connection_p);
+
+void *workerOperation(void *id);
+
+void handleSignal(int signal);
+
+int main(int argc, char *argv[]) {
+
+    //Retrieve and validate inputs
+    validateInput(argc, argv);
+
+    struct sockaddr_un address;
+    struct sigaction action;
+    struct epoll_event event, events[2];
+    sigset_t stopSignals;
+    pthread_t *threadHandlers;
+    int *threadId;
+    int listenFd, acceptEpoll, fd, i, ready;
+    unsigned long next = 0;
+
+    srand(time(NULL));
+
+    pthread_rwlock_init(&rwlock, NULL);
+    populate(n, &head);
+
+    //Stop on SIGINT or SIGTERM, waking the main thread through the self-pipe
+    if (pipe(stopPipe) != 0) {
+        printf("Error occured while opening the stop pipe \n");
+        exit(1);
+    }
+    fcntl(stopPipe[1], F_SETFL, fcntl(stopPipe[1], F_GETFL) | O_NONBLOCK);
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handleSignal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath, sizeof(address.sun_path) - 1);
+    unlink(socketPath);
+    if (listenFd < 0 || bind(listenFd, (struct sockaddr *) &address, sizeof(address)) != 0 ||
+        listen(listenFd, 128) != 0) {
+        printf("Error occured while opening the socket %s \n", socketPath);
+        exit(1);
+    }
+
+    //The workers inherit the blocked signals, only the main thread takes them
+    sigemptyset(&stopSignals);
+    sigaddset(&stopSignals, SIGINT);
+    sigaddset(&stopSignals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stopSignals, NULL);
+
+    threadHandlers = malloc(sizeof(pthread_t) * noOfThreads);
+    threadId = malloc(sizeof(int) * noOfThreads);
+    workerEpoll = malloc(sizeof(int) * noOfThreads);
+    for (i = 0; i < noOfThreads; i++) {
+        threadId[i] = i;
+        workerEpoll[i] = epoll_create1(0);
+        pthread_create(&threadHandlers[i], NULL, workerOperation, (void *) &threadId[i]);
+    }
+
+    pthread_sigmask(SIG_UNBLOCK, &stopSignals, NULL);
+
+    //The main thread waits for a connection or the stop signal
+    acceptEpoll = epoll_create1(0);
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    epoll_ctl(acceptEpoll, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.fd = stopPipe[0];
+    epoll_ctl(acceptEpoll, EPOLL_CTL_ADD, stopPipe[0], &event);
+
+    printf("Serving %d keys on %s\n", n, socketPath);
+
+    //Accept connections and hand them to the workers in turn
+    while (!isStopping) {
+        ready = epoll_wait(acceptEpoll, events, 2, -1);
+        if (ready <= 0 || isStopping)
+            continue;
+        fd = accept(listenFd, NULL, NULL);
+        if (fd < 0)
+            continue;
+
+        struct connection_s *connection_p = calloc(1, sizeof(struct connection_s));
+
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        connection_p->fd = fd;
+        event.events = EPOLLIN;
+        event.data.ptr = connection_p;
+        epoll_ctl(workerEpoll[next++ % noOfThreads], EPOLL_CTL_ADD, fd, &event);
+    }
+
+    for (i = 0; i < noOfThreads; i++)
+        pthread_join(threadHandlers[i], NULL);
+
+    close(acceptEpoll);
+    close(stopPipe[0]);
+    close(stopPipe[1]);
+    close(listenFd);
+    unlink(socketPath);
+    pthread_rwlock_destroy(&rwlock);
+
+    printf("Requests = %lu\n", totalRequests);
+    printf("Batches = %lu\n", totalBatches);
+    printf("Lock acquisitions = %lu\n", totalLockAcquisitions);
+    if (totalLockAcquisitions > 0)
+        printf("Requests per lock acquisition = %f\n", (double) totalRequests / totalLockAcquisitions);
+
+    free(threadHandlers);
+    free(threadId);
+    free(workerEpoll);
+    return 0;
+}
+
+//Only async-signal-safe calls : the flag and a write to the self-pipe
+void handleSignal(int signal) {
+    char byte = 1;
+
+    isStopping = 1;
+    if (write(stopPipe[1], &byte, 1) < 0)
+        return;
+}
+
+// Linked List Membership function
+int Member(int value, struct list_node_s *head_p) {
+    struct list_node_s *current_p = head_p;
+
+    while (current_p != NULL && current_p->data < value)
+        current_p = current_p->next;
+
+    if (current_p == NULL || current_p->data > value) {
+        return 0;
+    }
+    else {
+        return 1;
+    }
+
+}
+
+// Linked List Insertion function
+int Insert(int value, struct list_node_s **head_pp) {
+    struct list_node_s *curr_p = *head_pp;
+    struct list_node_s *pred_p = NULL;
+    struct list_node_s *temp_p = NULL;
+
+    while (curr_p != NULL && curr_p->data < value) {
+        pred_p = curr_p;
+        curr_p = curr_p->next;
+    }
+
+    if (curr_p == NULL || curr_p->data > value) {
+        temp_p = malloc(sizeof(struct list_node_s));
+        temp_p->data = value;
+        temp_p->next = curr_p;
+
+        if (pred_p == NULL)
+            *head_pp = temp_p;
+        else
+            pred_p->next = temp_p;
+
+        return 1;
+    }
+    else
+        return 0;
+}
+
+// Linked List Deletion function
+int Delete(int value, struct list_node_s **head_pp) {
+    struct list_node_s *curr_p = *head_pp;
+    struct list_node_s *pred_p = NULL;
+
+    while (curr_p != NULL && curr_p->data < value) {
+        pred_p = curr_p;
+        curr_p = curr_p->next;
+    }
+
+    if (curr_p != NULL && curr_p->data == value) {
+        if (pred_p == NULL)
+            *head_pp = curr_p->next;
+        else
+            pred_p->next = curr_p->next;
+        free(curr_p);
+
+        return 1;
+
+    }
+    else
+        return 0;
+}
+
+//Retrieve and validate the inputs
+void validateInput(int argc, char *argv[]) {
+
+    if (argc != 4) {
+        printf("Enter the command with arguments socketPath, noOfThreads and n\n");
+        exit(0);
+    }
+
+    //Input retrieval
+    socketPath = argv[1];
+    noOfThreads = (int) strtol(argv[2], (char**) NULL, 10);
+    n = (int) strtol(argv[3], (char**) NULL, 10);
+
+    //Input validation
+    if (noOfThreads <= 0 || noOfThreads > MAX_THREADS) {
+        printf("Invalid no. of Threads (0 < noOfThreads < %d)\n", MAX_THREADS);
+        exit(0);
+    } else if (n < 0 || n >= MAX_RANDOM) {
+        printf("Invalid input for n (0 <= n < %d)\n", MAX_RANDOM);
+        exit(0);
+    }
+}
+
+//Process the complete requests of a connection as one batch
+//Runs of Member requests share a read lock, runs of Insert/Delete requests a write lock
+int processBatch(struct connection_s *connection_p, unsigned long *lockAcquisitions) {
+    struct set_request_s *requests = (struct set_request_s *) connection_p->in;
+    int count = connection_p->inLength / REQUEST_SIZE;
+    int i = 0, isWrite, result;
+
+    while (i < count) {
+        isWrite = requests[i].op != SET_MEMBER;
+        if (isWrite)
+            pthread_rwlock_wrlock(&rwlock);
+        else
+            pthread_rwlock_rdlock(&rwlock);
+        (*lockAcquisitions)++;
+
+        for (; i < count && (requests[i].op != SET_MEMBER) == isWrite; i++) {
+            if (requests[i].op == SET_MEMBER)
+                result = Member(requests[i].key, head);
+            else if (requests[i].op == SET_INSERT)
+                result = Insert(requests[i].key, &head);
+            else if (requests[i].op == SET_DELETE)
+                result = Delete(requests[i].key, &head);
+            else
+                result = 0;
+            connection_p->out[connection_p->outLength++] = (char) result;
+        }
+
+        pthread_rwlock_unlock(&rwlock);
+    }
+
+    //Keep a trailing partial request for the next read
+    memmove(connection_p->in, connection_p->in + count * REQUEST_SIZE, connection_p->inLength - count * REQUEST_SIZE);
+    connection_p->inLength -= count * REQUEST_SIZE;
+    return count;
+}
+
+//Send pending responses, returns -1 if the connection failed
+int flushResponses(struct connection_s *connection_p) {
+    while (connection_p->outSent < connection_p->outLength) {
+        ssize_t sent = write(connection_p->fd, connection_p->out + connection_p->outSent,
+                             connection_p->outLength - connection_p->outSent);
+        if (sent < 0)
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+        connection_p->outSent += sent;
+    }
+    connection_p->outLength = 0;
+    connection_p->outSent = 0;
+    return 0;
+}
+
+void closeConnection(int epollFd, struct connection_s *connection_p) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, connection_p->fd, NULL);
+    close(connection_p->fd);
+    free(connection_p);
+}
+
+// Worker Operations, an epoll loop over the connections assigned to the worker
+void *workerOperation(void *workerId) {
+    int id = *(int *)workerId;
+    int epollFd = workerEpoll[id];
+    struct epoll_event events[MAX_EVENTS];
+    unsigned long requests = 0, lockAcquisitions = 0, batches = 0;
+    int ready, i;
+
+    while (!isStopping) {
+        ready = epoll_wait(epollFd, events, MAX_EVENTS, 100);
+
+        for (i = 0; i < ready; i++) {
+            struct connection_s *connection_p = events[i].data.ptr;
+            struct epoll_event event;
+            int isClosed = 0;
+
+            if (events[i].events & EPOLLIN) {
+                ssize_t received = read(connection_p->fd, connection_p->in + connection_p->inLength,
+                                        sizeof(connection_p->in) - connection_p->inLength);
+                if (received > 0) {
+                    connection_p->inLength += received;
+                    requests += processBatch(connection_p, &lockAcquisitions);
+                    batches++;
+                } else if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                    isClosed = 1;
+                }
+            } else if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                isClosed = 1;
+            }
+
+            if (!isClosed && flushResponses(connection_p) != 0)
+                isClosed = 1;
+
+            if (isClosed) {
+                closeConnection(epollFd, connection_p);
+                continue;
+            }
+
+            //Stop reading while responses are pending, the client has to drain them first
+            event.events = connection_p->outLength > 0 ? EPOLLOUT : EPOLLIN;
+            event.data.ptr = connection_p;
+            epoll_ctl(epollFd, EPOLL_CTL_MOD, connection_p->fd, &event);
+        }
+    }
+
+    __atomic_fetch_add(&totalRequests, requests, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&totalLockAcquisitions, lockAcquisitions, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&totalBatches, batches, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+//Linked list population function
+void populate(int n, struct list_node_s** head_pp){
+
+	int i;
+
+	for(i=0; i<n; ){
+		if(Insert(rand() % MAX_RANDOM, head_pp) == 1)
+			i++;
+	}
+}
@@ -0,0 +1,524 @@
+/*
+ * Linked List in shared memory, operated on by several processes
+ *
+ * The list (nodes, head and locks) lives in a shm_open/mmap segment. Nodes are
+ * linked by their index in the segment's node array rather than by pointers, so
+ * every process can map the segment at a different address. The locks are
+ * process-shared. One process creates and populates the list, the worker
+ * processes attach to it by name and run the Member/Insert/Delete mix.
+ *
+ * Compile : gcc -g -Wall -o shm_linked_list shm_linked_list.c -lm -lpthread -lrt
+ * Run : ./shm_linked_list noOfSamples n m noOfProcesses mMember mInsert mDelete lockType
+ *       lockType : 0 = mutex for entire list, 1 = read write lock
+ *
+ * */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h> 
+#include <pthread.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "sample_stats.h"
+
+#define MAX_PROCESSES 1024
+#define MAX_RANDOM 65535
+
+//Index marking the end of the list
+#define NIL UINT32_MAX
+
+//Lock types
+#define LOCK_MUTEX 0
+#define LOCK_RW 1
+
+// Number of samples
+int noOfSamples = 0;
+
+// Number of nodes in the linked list
+int n = 0;
+
+// Number of random operations in the linked list
+int m = 0;
+
+// Number of processes to execute
+int noOfProcesses = 0;
+
+// Lock protecting the list
+int lockType = LOCK_MUTEX;
+
+// Fractions of each operation
+float mInsert = 0.0, mDelete = 0.0, mMember = 0.0;
+
+// Total number of each operation
+int noOfInsert = 0, noOfDelete = 0, noOfMember = 0;
+
+//Name of the shared memory segment
+char segmentName[64];
+
+//Node definition, next is the index of the following node in the segment
+struct list_node_s {
+    int data;
+    uint32_t next;
+};
+
+//Shared list definition, the whole struct is the shared memory segment
+struct shm_list_s {
+    pthread_mutex_t mutex;
+    pthread_rwlock_t rwlock;
+    uint32_t head;
+    uint32_t capacity;
+    //Number of node slots handed out so far
+    uint32_t used;
+    //Deleted slots, linked through their next index
+    uint32_t freeList;
+    struct list_node_s nodes[];
+};
+
+int Insert(int value, struct shm_list_s *list_p);
+
+int Delete(int value, struct shm_list_s *list_p);
+
+int Member(int value, struct shm_list_s *list_p);
+
+struct shm_list_s *createList(char *name, uint32_t capacity);
+
+struct shm_list_s *attachList(char *name);
+
+void detachList(struct shm_list_s *list_p);
+
+void destroyList(char *name, struct shm_list_s *list_p);
+
+double calcChildTime(struct rusage *start, struct rusage *end);
+
+void validateInput(int argc, char *argv[]);
+
+void populate(int n, struct shm_list_s *list_p);
+
+void processOperation(int id);
+
+void writeOutput(double mean, double std);
+
+int main(int argc, char *argv[]) {
+
+    //Retrieve and validate inputs
+    validateInput(argc, argv);
+	
+	int sampleNumber = 0;
+	
+	//Time spend for a particular sample
+	double sampleTime = 0;
+	
+	//Mean of times of all the samples
+	double mean = 0;
+	
+	//Standard deviation of all the samples
+	double std = 0;  
+	
+	//CPU time of the worker processes, comparable to clock() of the threaded lists
+	struct rusage startUsage, endUsage;
+	
+	//Wall time at which sampling started, used for the sampling time cap
+	time_t samplingStart = time(NULL);
+    
+    //Random seed for random values
+    srand(time(NULL));
+
+    snprintf(segmentName, sizeof(segmentName), "/shm_linked_list_%d", (int) getpid());
+
+    for(sampleNumber = 0; sampleNumber < noOfSamples; sampleNumber++){
+		
+		//Defining processes
+		pid_t* processHandlers;
+		processHandlers = malloc(sizeof(pid_t) * noOfProcesses);
+		
+		// Calculating the total number of each operation
+		noOfInsert = mInsert * m;
+		noOfDelete = mDelete * m;
+		noOfMember = mMember * m;
+
+		//Creating the shared list, with room for every insert of the sample
+		struct shm_list_s *list_p = createList(segmentName, n + noOfInsert);
+				
+		//Populating linked list with random values	
+		populate(n, list_p);
+		
+		//Recording time at operations start
+		getrusage(RUSAGE_CHILDREN, &startUsage);
+
+		// Process Creation
+		int i = 0;
+		for (i = 0; i < noOfProcesses; i++) {
+			processHandlers[i] = fork();
+			if (processHandlers[i] == 0) {
+				processOperation(i);
+				_exit(0);
+			} else if (processHandlers[i] < 0) {
+				printf("Error occured while creating a process \n");
+				exit(1);
+			}
+		}
+
+		// Process Join
+		for (i = 0; i < noOfProcesses; i++) {
+			waitpid(processHandlers[i], NULL, 0);
+		}
+		
+		//Recording the time at operation ends
+		getrusage(RUSAGE_CHILDREN, &endUsage);
+
+		//Deallocate the shared list of this sample
+		destroyList(segmentName, list_p);
+		
+		//Deallocate the memory of this sample's process handlers
+		free(processHandlers);
+		
+		sampleTime = calcChildTime(&startUsage, &endUsage);
+		addSample(sampleTime);
+
+		//Stop as soon as the confidence target is met
+		if (isConfidenceReached())
+			break;
+
+		//Stop if the sampling time cap is exceeded
+		if (difftime(time(NULL), samplingStart) > MAX_SAMPLING_TIME)
+			break;
+	}
+	
+	//Calculate mean for all the samples
+	mean = runningMean;
+	
+	//Calculate Standard deviation for all the samples
+	std = findStd();
+	
+	writeOutput(mean, std);
+	writeRecord(lockType == LOCK_MUTEX ? "shm-mutex" : "shm-rw", noOfProcesses, n, m, mMember, mInsert, mDelete, mean, std);
+
+    return 0;
+}
+
+
+// Linked List Membership function
+int Member(int value, struct shm_list_s *list_p) {
+    uint32_t curr = list_p->head;
+
+    while (curr != NIL && list_p->nodes[curr].data < value)
+        curr = list_p->nodes[curr].next;
+
+    if (curr == NIL || list_p->nodes[curr].data > value) {
+        return 0;
+    }
+    else {
+        return 1;
+    }
+
+}
+
+// Linked List Insertion function
+int Insert(int value, struct shm_list_s *list_p) {
+    uint32_t curr = list_p->head;
+    uint32_t pred = NIL;
+    uint32_t temp = NIL;
+
+    while (curr != NIL && list_p->nodes[curr].data < value) {
+        pred = curr;
+        curr = list_p->nodes[curr].next;
+    }
+
+    if (curr == NIL || list_p->nodes[curr].data > value) {
+        if (list_p->freeList != NIL) {
+            temp = list_p->freeList;
+            list_p->freeList = list_p->nodes[temp].next;
+        } else if (list_p->used < list_p->capacity) {
+            temp = list_p->used++;
+        } else {
+            printf("Shared list is full \n");
+            exit(1);
+        }
+        list_p->nodes[temp].data = value;
+        list_p->nodes[temp].next = curr;
+
+        if (pred == NIL)
+            list_p->head = temp;
+        else
+            list_p->nodes[pred].next = temp;
+
+        return 1;
+    }
+    else
+        return 0;
+}
+
+// Linked List Deletion function
+int Delete(int value, struct shm_list_s *list_p) {
+    uint32_t curr = list_p->head;
+    uint32_t pred = NIL;
+
+    while (curr != NIL && list_p->nodes[curr].data < value) {
+        pred = curr;
+        curr = list_p->nodes[curr].next;
+    }
+
+    if (curr != NIL && list_p->nodes[curr].data == value) {
+        if (pred == NIL)
+            list_p->head = list_p->nodes[curr].next;
+        else
+            list_p->nodes[pred].next = list_p->nodes[curr].next;
+
+        //Return the slot to the free list
+        list_p->nodes[curr].next = list_p->freeList;
+        list_p->freeList = curr;
+
+        return 1;
+    }
+    else
+        return 0;
+}
+
+//Create a shared list segment with room for capacity nodes and process-shared locks
+struct shm_list_s *createList(char *name, uint32_t capacity) {
+    size_t size = sizeof(struct shm_list_s) + sizeof(struct list_node_s) * capacity;
+    struct shm_list_s *list_p;
+    pthread_mutexattr_t mutexAttr;
+    pthread_rwlockattr_t rwlockAttr;
+
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0 || ftruncate(fd, size) != 0) {
+        printf("Error occured while creating the shared memory segment \n");
+        exit(1);
+    }
+
+    list_p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (list_p == MAP_FAILED) {
+        printf("Error occured while mapping the shared memory segment \n");
+        exit(1);
+    }
+
+    pthread_mutexattr_init(&mutexAttr);
+    pthread_mutexattr_setpshared(&mutexAttr, PTHREAD_PROCESS_SHARED);
+    pthread_mutex_init(&list_p->mutex, &mutexAttr);
+    pthread_mutexattr_destroy(&mutexAttr);
+
+    pthread_rwlockattr_init(&rwlockAttr);
+    pthread_rwlockattr_setpshared(&rwlockAttr, PTHREAD_PROCESS_SHARED);
+    pthread_rwlock_init(&list_p->rwlock, &rwlockAttr);
+    pthread_rwlockattr_destroy(&rwlockAttr);
+
+    list_p->head = NIL;
+    list_p->capacity = capacity;
+    list_p->used = 0;
+    list_p->freeList = NIL;
+
+    return list_p;
+}
+
+//Attach to a shared list created by another process
+struct shm_list_s *attachList(char *name) {
+    struct shm_list_s *list_p;
+    size_t size;
+
+    int fd = shm_open(name, O_RDWR, 0600);
+    if (fd < 0) {
+        printf("Error occured while opening the shared memory segment \n");
+        exit(1);
+    }
+
+    //Map the header first to learn the capacity, then the whole segment
+    list_p = mmap(NULL, sizeof(struct shm_list_s), PROT_READ, MAP_SHARED, fd, 0);
+    if (list_p == MAP_FAILED) {
+        printf("Error occured while mapping the shared memory segment \n");
+        exit(1);
+    }
+    size = sizeof(struct shm_list_s) + sizeof(struct list_node_s) * list_p->capacity;
+    munmap(list_p, sizeof(struct shm_list_s));
+
+    list_p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (list_p == MAP_FAILED) {
+        printf("Error occured while mapping the shared memory segment \n");
+        exit(1);
+    }
+    return list_p;
+}
+
+//Unmap the shared list from this process
+void detachList(struct shm_list_s *list_p) {
+    munmap(list_p, sizeof(struct shm_list_s) + sizeof(struct list_node_s) * list_p->capacity);
+}
+
+//Destroy the locks and remove the shared list segment
+void destroyList(char *name, struct shm_list_s *list_p) {
+    pthread_mutex_destroy(&list_p->mutex);
+    pthread_rwlock_destroy(&list_p->rwlock);
+    detachList(list_p);
+    shm_unlink(name);
+}
+
+//Retrieve and validate the inputs
+void validateInput(int argc, char *argv[]) {
+
+    
+    if (argc != 9) {
+        printf("Enter the command with arguments noOfSamples, n, m, noOfProcesses, mMember, mInsert, mDelete and lockType\n");
+        exit(0);
+    }
+    
+    //Input retrieval
+	noOfSamples = (int) strtol(argv[1], (char**) NULL, 10);
+    n = (int) strtol(argv[2], (char**) NULL, 10);
+    m = (int) strtol(argv[3], (char**) NULL, 10);
+	noOfProcesses = (int) strtol(argv[4], (char**) NULL, 10);
+    mMember = (float) atof(argv[5]);
+    mInsert = (float) atof(argv[6]);
+    mDelete = (float) atof(argv[7]);
+    lockType = (int) strtol(argv[8], (char**) NULL, 10);
+
+    //Input validation
+	if (noOfSamples <= 0){
+		printf("Invalid input for noOfSamples (noOfSamples > 0)\n");
+		exit(0);
+	} else if (n <= 0 || n >= MAX_RANDOM){
+		printf("Invalid input for n (0 < n < %d)\n", MAX_RANDOM);
+		exit(0);
+	}else if (m <= 0){
+		printf("Invalid input for m (m > 0)\n");
+		exit(0);
+
+	}else if (mMember + mInsert + mDelete != 1.0){
+		printf("Invalid combination of fractions (Total = 1.0)\n");
+		exit(0);
+	}
+	
+    if (noOfProcesses <= 0 || noOfProcesses > MAX_PROCESSES) {
+        printf("Invalid no. of Processes (0 < noOfProcesses < %d)\n", MAX_PROCESSES);
+        exit(0);
+    }
+
+    if (lockType != LOCK_MUTEX && lockType != LOCK_RW) {
+        printf("Invalid lockType (0 = mutex, 1 = read write lock)\n");
+        exit(0);
+    }
+}
+
+//Lock the shared list for reading or for writing
+void lockList(struct shm_list_s *list_p, int isWrite) {
+    if (lockType == LOCK_MUTEX)
+        pthread_mutex_lock(&list_p->mutex);
+    else if (isWrite)
+        pthread_rwlock_wrlock(&list_p->rwlock);
+    else
+        pthread_rwlock_rdlock(&list_p->rwlock);
+}
+
+void unlockList(struct shm_list_s *list_p) {
+    if (lockType == LOCK_MUTEX)
+        pthread_mutex_unlock(&list_p->mutex);
+    else
+        pthread_rwlock_unlock(&list_p->rwlock);
+}
+
+// Process Operations, run by each worker process on its own mapping of the list
+void processOperation(int id) {
+	
+	//Number of each operations allocated for the process
+	int noOfProcessTotal = 0;
+    int noOfProcessInsert = 0;
+    int noOfProcessDelete = 0;
+    int noOfProcessMember = 0;
+
+    struct shm_list_s *list_p = attachList(segmentName);
+
+    //Each process needs its own random sequence
+    srand(time(NULL) ^ (getpid() << 16));
+    
+    //Calculate the number of each operation for this process
+    noOfProcessMember = noOfMember / noOfProcesses + (noOfMember % noOfProcesses > id ? 1 : 0);
+    noOfProcessInsert = noOfInsert / noOfProcesses + (noOfInsert % noOfProcesses > id ? 1 : 0);
+    noOfProcessDelete = noOfDelete / noOfProcesses + (noOfDelete % noOfProcesses > id ? 1 : 0);
+
+    noOfProcessTotal = noOfProcessInsert + noOfProcessDelete + noOfProcessMember;
+
+    int totalExecuted = 0;
+	int memberExecuted = 0;
+	int insertExecuted = 0;
+	int deleteExecuted = 0;
+
+    while (totalExecuted < noOfProcessTotal) {
+
+        int randomNumber = rand() % MAX_RANDOM;
+        int randomOperation = rand() % 3;
+
+        if (randomOperation == 0 && memberExecuted < noOfProcessMember) {
+            lockList(list_p, 0);
+            Member(randomNumber, list_p);
+            unlockList(list_p);
+            memberExecuted++;
+        }
+        else if (randomOperation == 1 && insertExecuted < noOfProcessInsert) {
+            lockList(list_p, 1);
+            Insert(randomNumber, list_p);
+            unlockList(list_p);
+            insertExecuted++;
+        }
+        else if (randomOperation == 2 && deleteExecuted < noOfProcessDelete) {
+            lockList(list_p, 1);
+            Delete(randomNumber, list_p);
+            unlockList(list_p);
+            deleteExecuted++;
+        }
+        totalExecuted = insertExecuted + memberExecuted + deleteExecuted;   
+    }
+
+    detachList(list_p);
+}
+
+//Linked list population function
+void populate(int n, struct shm_list_s *list_p){
+	
+	int num,i;
+  
+	for(i=0; i<n; ){
+		num = rand() % MAX_RANDOM;
+		if(Insert(num, list_p) == 1)
+			i++;	  
+	}
+}
+
+//CPU time spent by the worker processes between two resource usage readings
+double calcChildTime(struct rusage *start, struct rusage *end) {
+    return (end->ru_utime.tv_sec - start->ru_utime.tv_sec) + (end->ru_stime.tv_sec - start->ru_stime.tv_sec) +
+           ((end->ru_utime.tv_usec - start->ru_utime.tv_usec) + (end->ru_stime.tv_usec - start->ru_stime.tv_usec)) / 1e6;
+}
+
+void writeOutput(double mean, double std) {
+	FILE *f = fopen("results.txt", "a"); 
+	if (f == NULL)
+	{
+		printf("Error occured while opening the file \n");        
+		exit(1);
+	}
+	
+	fprintf(f,"\n === Shared Memory, %s === \n\n", lockType == LOCK_MUTEX ? "Mutex for entire list" : "Read Write Lock"); 
+	fprintf(f,"Number of Nodes = %d\n", n);
+	fprintf(f,"Number of Operations = %d\n", m);
+	fprintf(f,"Member Fraction= %.2f\n", mMember);  
+	fprintf(f,"Insert Fraction = %.3f\n", mInsert);  
+	fprintf(f,"Delete Fraction = %.3f\n", mDelete); 
+	fprintf(f,"Number of Processes = %d\n", noOfProcesses); 
+	fprintf(f,"Max Number of Samples = %d\n", noOfSamples);
+	fprintf(f,"Number of Samples = %d\n", acceptedSamples);
+	fprintf(f,"Rejected Outliers = %d\n", rejectedSamples);
+	fprintf(f,"Min number of samples needed = %f\n", minNoOfSamples);  
+	fprintf(f,"Mean = %f\n", mean);  
+	fprintf(f,"Standard Deviation = %f\n", std);
+	fprintf(f,"Throughput (ops/sec) = %f\n", mean > 0 ? m / mean : 0.0);
+	fprintf(f,"Confidence Interval (95%%) = +/- %f (%.2f%% of mean)\n", 1.96*std/sqrt(acceptedSamples), mean > 0 ? 100*1.96*std/sqrt(acceptedSamples)/mean : 0.0);
+	fprintf(f,"________________________________________ \n\n");                   
+	
+	fclose(f); 
+}
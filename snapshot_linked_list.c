@@ -0,0 +1,813 @@
+/*
+ * Read optimized set : frozen sorted array snapshot with a delta list
+ *
+ * The keys live in an immutable sorted array (the snapshot). Insert/Delete only touch
+ * a small sorted delta list holding recent inserts and tombstones of snapshot keys.
+ * The snapshot and its delta make up a version, published through one atomic pointer.
+ *
+ * Member takes no lock : it loads the current version, checks the delta and otherwise
+ * does a branchless binary search of the snapshot. Writers serialize on their own mutex
+ * and change the delta with single pointer stores, so a concurrent Member sees each
+ * Insert/Delete either whole or not at all. An unlinked delta entry is retired, not freed.
+ *
+ * A background thread merges the delta into a new snapshot when it grows past
+ * MERGE_THRESHOLD entries. The merge is built without any lock and published as a new
+ * version with an empty delta under the writers' mutex. Readers still on the old version
+ * finish on that consistent pair. The old version is retired, and retired blocks are
+ * freed once every thread has been seen outside an operation (a quiescent point).
+ *
+ * Takes the same arguments and runs the same operation mix as the read write lock list,
+ * so its results compare directly with rw_linked_list.
+ *
+ * Compile : gcc -g -Wall -o snapshot_linked_list snapshot_linked_list.c -lm -lpthread
+ * Run : ./snapshot_linked_list noOfSamples n m noOfThreads mMember mInsert mDelete
+ *
+ * */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <math.h>
+#include <unistd.h>
+
+
+#define MAX_THREADS 1024
+#define MAX_RANDOM 65535
+
+#include "lock_profile.h"
+#include "memory_stats.h"
+#include "sample_clock.h"
+#include "sample_stats.h"
+
+//Delta entries above which the background thread merges them into a new snapshot
+#define MERGE_THRESHOLD 16
+
+//Period (microseconds) at which the background thread checks the delta
+#define MERGE_INTERVAL 200
+
+// Number of samples
+int noOfSamples = 0;
+
+// Number of nodes in the linked list
+int n = 0;
+
+// Number of random operations in the linked list
+int m = 0;
+
+// Number of threads to execute
+int noOfThreads = 0;
+
+// Fractions of each operation
+float mInsert = 0.0, mDelete = 0.0, mMember = 0.0;
+
+// Total number of each operation
+int noOfInsert = 0, noOfDelete = 0, noOfMember = 0;
+
+//Set to stop the background merge thread
+int stopMerge = 0;
+
+//Merge statistics of the run
+long merges = 0;
+long reclaims = 0;
+double mergePauseTotal = 0.0, mergePauseMax = 0.0;
+
+//Serializes the writers and the publication of a merge, readers never take it
+pthread_mutex_t writeMutex;
+
+//Snapshot definition, never modified once published
+struct snapshot_s {
+    int *keys;
+    int count;
+};
+
+//Delta entry definition, a key inserted since the snapshot or a tombstone of a snapshot key
+//Only next changes once the entry is linked
+struct delta_node_s {
+    int data;
+    int isDeleted;
+    struct delta_node_s *next;
+};
+
+//Version definition, a snapshot and the delta applied to it
+//A live delta entry is never in the snapshot and a tombstone always is
+struct version_s {
+    struct snapshot_s *snapshot;
+    struct delta_node_s *delta;
+    int deltaCount;
+};
+
+//Set definition
+struct set_s {
+    struct version_s *current;
+    //Number of successful Insert/Delete calls, used to validate a merge
+    unsigned long modifications;
+};
+
+struct set_s set;
+
+//Per thread state, the epoch is odd while the thread is inside an operation
+struct thread_state_s {
+    unsigned long epoch;
+} __attribute__((aligned(64)));
+
+struct thread_state_s threadStates[MAX_THREADS];
+
+//Blocks unreachable from the current version, freed at the next quiescent point
+void **retired = NULL;
+long retiredCount = 0;
+long retiredCapacity = 0;
+double retiredBytes = 0.0;
+
+int Insert(int value, struct set_s *set_p);
+
+int Delete(int value, struct set_s *set_p);
+
+int Member(int value, struct set_s *set_p);
+
+int searchSnapshot(struct snapshot_s *snapshot_p, int value);
+
+struct delta_node_s *findDelta(int value, struct version_s *version_p, struct delta_node_s **pred_pp);
+
+void addDelta(int value, int isDeleted, struct version_s *version_p, struct delta_node_s *pred_p);
+
+void removeDelta(struct version_s *version_p, struct delta_node_s *pred_p, struct delta_node_s *curr_p);
+
+struct snapshot_s *mergeSnapshot(struct snapshot_s *snapshot_p, struct delta_node_s *delta_p);
+
+void freeSnapshot(struct snapshot_s *snapshot_p);
+
+void freeDelta(struct delta_node_s *delta_p);
+
+void retireBlock(void *block_p, size_t size);
+
+void retireVersion(struct version_s *version_p);
+
+void freeRetired();
+
+void enterOperation(struct thread_state_s *state_p);
+
+void exitOperation(struct thread_state_s *state_p);
+
+void Merge();
+
+void *mergeOperation();
+
+double calcTime(clock_t startTime, clock_t endTime);
+
+double wallTime();
+
+void validateInput(int argc, char *argv[]);
+
+void populate(int n, struct set_s *set_p);
+
+void destroy(struct set_s *set_p);
+
+void measureMemory(struct set_s *set_p);
+
+void *threadOperation(void *id);
+
+void writeOutput(double mean, double std);
+
+int main(int argc, char *argv[]) {
+
+    //Retrieve and validate inputs
+    validateInput(argc, argv);
+
+	int sampleNumber = 0;
+
+	//Time spend for a particular sample
+	double sampleTime = 0;
+
+	//Mean of times of all the samples
+	double mean = 0;
+
+	//Standard deviation of all the samples
+	double std = 0;
+
+	//Time keeping variables
+    clock_t startTime, endTime;
+
+	//Background merge thread
+	pthread_t mergeHandler;
+
+	//Wall time at which sampling started, used for the sampling time cap
+	time_t samplingStart = time(NULL);
+
+    //Random seed for random values
+    srand(time(NULL));
+
+    for(sampleNumber = 0; sampleNumber < noOfSamples; sampleNumber++){
+
+		//Defining threads
+		pthread_t* threadHandlers;
+		threadHandlers = malloc(sizeof(pthread_t) * noOfThreads);
+
+		// Calculating the total number of each operation
+		noOfInsert = mInsert * m;
+		noOfDelete = mDelete * m;
+		noOfMember = mMember * m;
+
+		int *threadId;
+		threadId = (int *)malloc(sizeof(int) * noOfThreads);
+
+		resetPeakRss();
+
+		//Populating the snapshot with random values
+		populate(n, &set);
+
+		// Initializing the writers' mutex
+		pthread_mutex_init(&writeMutex, NULL);
+
+		//Starting the background merge
+		stopMerge = 0;
+		pthread_create(&mergeHandler, NULL, mergeOperation, NULL);
+
+		//Recording time at operations start
+		startTime = clock();
+		sampleClockStart();
+		sampleClockThreads(noOfThreads);
+
+		// Thread Creation
+		int i = 0;
+		for (i = 0; i < noOfThreads; i++) {
+			threadId[i] = i;
+			pthread_create(&threadHandlers[i], NULL, threadOperation, (void *) &threadId[i]);
+		}
+
+		// Thread Join
+		for (i = 0; i < noOfThreads; i++) {
+			pthread_join(threadHandlers[i], NULL);
+		}
+
+		//Recording the time at operation ends
+		endTime = clock();
+		sampleClockStop();
+
+		// Stopping the background merge
+		__atomic_store_n(&stopMerge, 1, __ATOMIC_RELAXED);
+		pthread_join(mergeHandler, NULL);
+
+		// Destroying the writers' mutex
+		pthread_mutex_destroy(&writeMutex);
+
+		//Deallocate the memory of this sample's set
+		measureMemory(&set);
+		destroy(&set);
+
+		//Deallocate the memory of this sample's thread handlers
+		free(threadHandlers);
+		free(threadId);
+
+		sampleTime = sampleClockTime(calcTime(startTime, endTime));
+		addSample(sampleTime);
+
+		//Stop as soon as the confidence target is met
+		if (isConfidenceReached())
+			break;
+
+		//Stop if the sampling time cap is exceeded
+		if (difftime(time(NULL), samplingStart) > MAX_SAMPLING_TIME)
+			break;
+	}
+
+	//Calculate mean for all the samples
+	mean = runningMean;
+
+	//Calculate Standard deviation for all the samples
+	std = findStd();
+
+	writeOutput(mean, std);
+	writeRecord("snapshot", noOfThreads, n, m, mMember, mInsert, mDelete, mean, std);
+
+    return 0;
+}
+
+
+//Branchless binary search of the snapshot
+//Each step keeps the half holding the last key <= value, selected with a conditional move
+int searchSnapshot(struct snapshot_s *snapshot_p, int value) {
+    const int *base_p = snapshot_p->keys;
+    int length = snapshot_p->count;
+    int half;
+
+    if (length == 0)
+        return 0;
+
+    while (length > 1) {
+        half = length / 2;
+        base_p = base_p[half] <= value ? base_p + half : base_p;
+        length -= half;
+    }
+    return *base_p == value;
+}
+
+//Delta entry of a key, or NULL, with its predecessor in *pred_pp
+//Safe without the writers' mutex, every link is loaded with acquire ordering
+struct delta_node_s *findDelta(int value, struct version_s *version_p, struct delta_node_s **pred_pp) {
+    struct delta_node_s *curr_p = __atomic_load_n(&version_p->delta, __ATOMIC_ACQUIRE);
+    struct delta_node_s *pred_p = NULL;
+
+    while (curr_p != NULL && curr_p->data < value) {
+        pred_p = curr_p;
+        curr_p = __atomic_load_n(&curr_p->next, __ATOMIC_ACQUIRE);
+    }
+
+    *pred_pp = pred_p;
+    if (curr_p != NULL && curr_p->data == value)
+        return curr_p;
+    return NULL;
+}
+
+//Link a new entry after pred_p, called with the writers' mutex held
+//The entry is complete before the release store makes it reachable
+void addDelta(int value, int isDeleted, struct version_s *version_p, struct delta_node_s *pred_p) {
+    struct delta_node_s *temp_p = malloc(sizeof(struct delta_node_s));
+    struct delta_node_s **link_pp = pred_p == NULL ? &version_p->delta : &pred_p->next;
+
+    temp_p->data = value;
+    temp_p->isDeleted = isDeleted;
+    temp_p->next = *link_pp;
+    __atomic_store_n(link_pp, temp_p, __ATOMIC_RELEASE);
+    __atomic_store_n(&version_p->deltaCount, version_p->deltaCount + 1, __ATOMIC_RELAXED);
+}
+
+//Unlink an entry, called with the writers' mutex held
+//A reader may still be on the entry, its next is left intact and it is only retired
+void removeDelta(struct version_s *version_p, struct delta_node_s *pred_p, struct delta_node_s *curr_p) {
+    struct delta_node_s **link_pp = pred_p == NULL ? &version_p->delta : &pred_p->next;
+
+    __atomic_store_n(link_pp, curr_p->next, __ATOMIC_RELEASE);
+    __atomic_store_n(&version_p->deltaCount, version_p->deltaCount - 1, __ATOMIC_RELAXED);
+    retireBlock(curr_p, sizeof(struct delta_node_s));
+}
+
+// Set Membership function, runs without a lock
+int Member(int value, struct set_s *set_p) {
+    struct version_s *version_p = __atomic_load_n(&set_p->current, __ATOMIC_ACQUIRE);
+    struct delta_node_s *pred_p;
+    struct delta_node_s *curr_p = findDelta(value, version_p, &pred_p);
+
+    if (curr_p != NULL)
+        return !curr_p->isDeleted;
+    return searchSnapshot(version_p->snapshot, value);
+}
+
+// Set Insertion function, called with the writers' mutex held
+int Insert(int value, struct set_s *set_p) {
+    struct version_s *version_p = set_p->current;
+    struct delta_node_s *pred_p;
+    struct delta_node_s *curr_p = findDelta(value, version_p, &pred_p);
+
+    if (curr_p != NULL) {
+        if (!curr_p->isDeleted)
+            return 0;
+        //Reinserting a deleted snapshot key drops its tombstone
+        removeDelta(version_p, pred_p, curr_p);
+    } else if (searchSnapshot(version_p->snapshot, value)) {
+        return 0;
+    } else {
+        addDelta(value, 0, version_p, pred_p);
+    }
+
+    __atomic_store_n(&set_p->modifications, set_p->modifications + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+// Set Deletion function, called with the writers' mutex held
+int Delete(int value, struct set_s *set_p) {
+    struct version_s *version_p = set_p->current;
+    struct delta_node_s *pred_p;
+    struct delta_node_s *curr_p = findDelta(value, version_p, &pred_p);
+
+    if (curr_p != NULL) {
+        if (curr_p->isDeleted)
+            return 0;
+        //Deleting a key inserted since the snapshot just drops its entry
+        removeDelta(version_p, pred_p, curr_p);
+    } else if (searchSnapshot(version_p->snapshot, value)) {
+        addDelta(value, 1, version_p, pred_p);
+    } else {
+        return 0;
+    }
+
+    __atomic_store_n(&set_p->modifications, set_p->modifications + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+//New snapshot holding the snapshot keys and the delta applied to them
+struct snapshot_s *mergeSnapshot(struct snapshot_s *snapshot_p, struct delta_node_s *delta_p) {
+    struct snapshot_s *merged_p = malloc(sizeof(struct snapshot_s));
+    int count = snapshot_p->count;
+    struct delta_node_s *curr_p;
+    int i = 0;
+
+    for (curr_p = delta_p; curr_p != NULL; curr_p = __atomic_load_n(&curr_p->next, __ATOMIC_ACQUIRE))
+        count += curr_p->isDeleted ? -1 : 1;
+
+    //Room for every snapshot key and delta entry, the delta may change while it is merged
+    merged_p->keys = malloc(sizeof(int) * (count > 0 ? count : 1));
+    merged_p->count = 0;
+
+    curr_p = delta_p;
+    while ((i < snapshot_p->count || curr_p != NULL) && merged_p->count < count) {
+        if (curr_p == NULL || (i < snapshot_p->count && snapshot_p->keys[i] < curr_p->data)) {
+            merged_p->keys[merged_p->count++] = snapshot_p->keys[i++];
+        } else if (i < snapshot_p->count && snapshot_p->keys[i] == curr_p->data) {
+            //Tombstone, the key is dropped
+            i++;
+            curr_p = __atomic_load_n(&curr_p->next, __ATOMIC_ACQUIRE);
+        } else {
+            merged_p->keys[merged_p->count++] = curr_p->data;
+            curr_p = __atomic_load_n(&curr_p->next, __ATOMIC_ACQUIRE);
+        }
+    }
+
+    return merged_p;
+}
+
+void freeSnapshot(struct snapshot_s *snapshot_p) {
+    free(snapshot_p->keys);
+    free(snapshot_p);
+}
+
+void freeDelta(struct delta_node_s *delta_p) {
+    struct delta_node_s *next_p;
+
+    while (delta_p != NULL) {
+        next_p = delta_p->next;
+        free(delta_p);
+        delta_p = next_p;
+    }
+}
+
+//Keep a block until the next quiescent point, called with the writers' mutex held
+void retireBlock(void *block_p, size_t size) {
+    if (retiredCount == retiredCapacity) {
+        retiredCapacity = retiredCapacity > 0 ? 2 * retiredCapacity : 256;
+        retired = realloc(retired, sizeof(void *) * retiredCapacity);
+    }
+    retired[retiredCount++] = block_p;
+    retiredBytes += size;
+}
+
+//Retire a version replaced by a merge, with its snapshot and every entry of its delta
+void retireVersion(struct version_s *version_p) {
+    struct delta_node_s *curr_p;
+
+    for (curr_p = version_p->delta; curr_p != NULL; curr_p = curr_p->next)
+        retireBlock(curr_p, sizeof(struct delta_node_s));
+    retireBlock(version_p->snapshot->keys, sizeof(int) * (size_t) version_p->snapshot->count);
+    retireBlock(version_p->snapshot, sizeof(struct snapshot_s));
+    retireBlock(version_p, sizeof(struct version_s));
+}
+
+//Free the blocks retired so far once every thread has passed a quiescent point
+//A thread outside an operation, or which has left the one it was in, can no longer
+//hold a block that was unreachable before the wait started
+void freeRetired() {
+    void **blocks;
+    long count, i;
+    unsigned long epoch;
+
+    pthread_mutex_lock(&writeMutex);
+    blocks = retired;
+    count = retiredCount;
+    retired = NULL;
+    retiredCount = retiredCapacity = 0;
+    retiredBytes = 0.0;
+    pthread_mutex_unlock(&writeMutex);
+
+    if (count == 0) {
+        free(blocks);
+        return;
+    }
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    for (i = 0; i < noOfThreads; i++) {
+        epoch = __atomic_load_n(&threadStates[i].epoch, __ATOMIC_SEQ_CST);
+        if (epoch % 2 == 0)
+            continue;
+        while (__atomic_load_n(&threadStates[i].epoch, __ATOMIC_SEQ_CST) == epoch)
+            sched_yield();
+    }
+
+    for (i = 0; i < count; i++)
+        free(blocks[i]);
+    free(blocks);
+    reclaims++;
+}
+
+//Mark the thread inside an operation, before it loads the current version
+void enterOperation(struct thread_state_s *state_p) {
+    __atomic_store_n(&state_p->epoch, state_p->epoch + 1, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void exitOperation(struct thread_state_s *state_p) {
+    __atomic_store_n(&state_p->epoch, state_p->epoch + 1, __ATOMIC_RELEASE);
+}
+
+//Merge the delta into a new snapshot and publish it as a new version
+//The merge is built without a lock, only the publication holds up the writers
+void Merge() {
+	struct version_s *oldVersion_p = __atomic_load_n(&set.current, __ATOMIC_ACQUIRE);
+	struct version_s *newVersion_p = malloc(sizeof(struct version_s));
+	struct snapshot_s *newSnapshot_p;
+	unsigned long version;
+	double pauseStart, pause;
+
+	version = __atomic_load_n(&set.modifications, __ATOMIC_ACQUIRE);
+	newSnapshot_p = mergeSnapshot(oldVersion_p->snapshot, __atomic_load_n(&oldVersion_p->delta, __ATOMIC_ACQUIRE));
+
+	pthread_mutex_lock(&writeMutex);
+	pauseStart = wallTime();
+	if (set.modifications != version) {
+		//The delta changed during the merge, build it again under the mutex
+		freeSnapshot(newSnapshot_p);
+		newSnapshot_p = mergeSnapshot(oldVersion_p->snapshot, oldVersion_p->delta);
+	}
+	newVersion_p->snapshot = newSnapshot_p;
+	newVersion_p->delta = NULL;
+	newVersion_p->deltaCount = 0;
+	__atomic_store_n(&set.current, newVersion_p, __ATOMIC_RELEASE);
+	retireVersion(oldVersion_p);
+	pthread_mutex_unlock(&writeMutex);
+
+	pause = wallTime() - pauseStart;
+	merges++;
+	mergePauseTotal += pause;
+	if (pause > mergePauseMax)
+		mergePauseMax = pause;
+}
+
+//Background merge, triggered when the delta exceeds MERGE_THRESHOLD entries
+//Retired blocks are freed at every check, so they do not pile up between merges
+void *mergeOperation() {
+	struct version_s *version_p;
+
+	while (!__atomic_load_n(&stopMerge, __ATOMIC_RELAXED)) {
+		usleep(MERGE_INTERVAL);
+
+		version_p = __atomic_load_n(&set.current, __ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&version_p->deltaCount, __ATOMIC_RELAXED) > MERGE_THRESHOLD)
+			Merge();
+		freeRetired();
+	}
+	return NULL;
+}
+
+//Free the current version and the retired blocks, leaving the set empty
+//Called once every thread has been joined
+void destroy(struct set_s *set_p) {
+	long i;
+
+	freeSnapshot(set_p->current->snapshot);
+	freeDelta(set_p->current->delta);
+	free(set_p->current);
+	set_p->current = NULL;
+
+	for (i = 0; i < retiredCount; i++)
+		free(retired[i]);
+	free(retired);
+	retired = NULL;
+	retiredCount = retiredCapacity = 0;
+	retiredBytes = 0.0;
+}
+
+//Record the memory footprint of the set at the end of a sample
+//Tombstones are retired keys which still take space until the next merge, as are the
+//blocks waiting for a quiescent point
+void measureMemory(struct set_s *set_p) {
+	struct version_s *version_p = set_p->current;
+	struct delta_node_s *curr_p;
+	long live = version_p->snapshot->count;
+	long tombstones = 0;
+	long i;
+	double allocated = allocatedSize(version_p) + allocatedSize(version_p->snapshot) +
+			allocatedSize(version_p->snapshot->keys);
+	double requested = sizeof(int) * (double) version_p->snapshot->count;
+
+	for (i = 0; i < retiredCount; i++)
+		allocated += allocatedSize(retired[i]);
+
+	for (curr_p = version_p->delta; curr_p != NULL; curr_p = curr_p->next) {
+		allocated += allocatedSize(curr_p);
+		if (curr_p->isDeleted) {
+			live--;
+			tombstones++;
+		} else {
+			live++;
+			requested += sizeof(struct delta_node_s);
+		}
+	}
+	recordMemory(live, requested, allocated, (double) tombstones * sizeof(struct delta_node_s) + retiredBytes);
+}
+
+//Retrieve and validate the inputs
+void validateInput(int argc, char *argv[]) {
+
+
+    if (argc != 8) {
+        printf("Enter the command with arguments noOfSamples, n, m, noOfThreads, mMember, mInsert and mDelete\n");
+        exit(0);
+    }
+
+    //Input retrieval
+	noOfSamples = (int) strtol(argv[1], (char**) NULL, 10);
+    n = (int) strtol(argv[2], (char**) NULL, 10);
+    m = (int) strtol(argv[3], (char**) NULL, 10);
+	noOfThreads = (int) strtol(argv[4], (char**) NULL, 10);
+    mMember = (float) atof(argv[5]);
+    mInsert = (float) atof(argv[6]);
+    mDelete = (float) atof(argv[7]);
+
+    //Input validation
+	if (noOfSamples <= 0){
+		printf("Invalid input for noOfSamples (noOfSamples > 0)\n");
+		exit(0);
+	} else if (n <= 0 || n >= MAX_RANDOM){
+		printf("Invalid input for n (0 < n < %d)\n", MAX_RANDOM);
+		exit(0);
+	}else if (m <= 0){
+		printf("Invalid input for m (m > 0)\n");
+		exit(0);
+
+	}else if (mMember + mInsert + mDelete != 1.0){
+		printf("Invalid combination of fractions (Total = 1.0)\n");
+		exit(0);
+	}
+
+    //Input validation
+    if (noOfThreads <= 0 || noOfThreads > MAX_THREADS) {
+        printf("Invalid no. of Threads (0 < noOfThreads < %d)", MAX_THREADS);
+        exit(0);
+    }
+}
+
+// Thread Operations
+void *threadOperation(void *threadId) {
+
+	//Number of each operations allocated for the thread
+	int noOfThreadTotal = 0;
+    int noOfThreadInsert = 0;
+    int noOfThreadDelete = 0;
+    int noOfThreadMember = 0;
+
+    int id = *(int *)threadId;
+    struct thread_state_s *state_p = &threadStates[id];
+
+    sampleClockThreadStart();
+    PROFILE_THREAD_START(id);
+
+    //Calculate the number of member operations per thread
+    if (noOfMember % noOfThreads <= id) {
+        noOfThreadMember = noOfMember / noOfThreads;
+    }
+    else {
+        noOfThreadMember = noOfMember / noOfThreads + 1;
+    }
+
+    //Calculate the number of insert operations per thread
+    if (noOfInsert % noOfThreads <= id) {
+        noOfThreadInsert = noOfInsert / noOfThreads;
+    }
+    else {
+        noOfThreadInsert = noOfInsert / noOfThreads + 1;
+    }
+
+    //Calculate the number of delete operations per thread
+    if (noOfDelete % noOfThreads <= id) {
+        noOfThreadDelete = noOfDelete / noOfThreads;
+    }
+    else{
+        noOfThreadDelete = noOfDelete / noOfThreads + 1;
+    }
+
+    noOfThreadTotal = noOfThreadInsert + noOfThreadDelete + noOfThreadMember;
+
+    int totalExecuted = 0;
+	int memberExecuted = 0;
+	int insertExecuted = 0;
+	int deleteExecuted = 0;
+
+	int isMemberFinished = 0;
+	int isInsertFinished = 0;
+	int isDeleteFinished = 0;
+
+    while (totalExecuted < noOfThreadTotal) {
+
+        int randomNumber = rand() % MAX_RANDOM;
+        int randomOperation = rand() % 3;
+
+        if (randomOperation == 0 && isMemberFinished == 0) {
+            if (memberExecuted < noOfThreadMember) {
+                enterOperation(state_p);
+                Member(randomNumber, &set);
+                exitOperation(state_p);
+                memberExecuted++;
+            } else
+                isMemberFinished = 1;
+        }
+        else if (randomOperation == 1 && isInsertFinished == 0) {
+            if (insertExecuted < noOfThreadInsert) {
+                enterOperation(state_p);
+                MUTEX_LOCK(&writeMutex, OP_INSERT);
+                Insert(randomNumber, &set);
+                MUTEX_UNLOCK(&writeMutex, OP_INSERT);
+                exitOperation(state_p);
+                insertExecuted++;
+            } else
+                isInsertFinished = 1;
+        }
+        else if (randomOperation == 2 && isDeleteFinished == 0) {
+
+            if (deleteExecuted < noOfThreadDelete) {
+                enterOperation(state_p);
+                MUTEX_LOCK(&writeMutex, OP_DELETE);
+                Delete(randomNumber, &set);
+                MUTEX_UNLOCK(&writeMutex, OP_DELETE);
+                exitOperation(state_p);
+                deleteExecuted++;
+            } else
+                isDeleteFinished = 1;
+        }
+        totalExecuted = insertExecuted + memberExecuted + deleteExecuted;
+    }
+    return NULL;
+}
+
+//Wall clock time in seconds
+double wallTime() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//Set population function, the keys go straight into a sorted snapshot
+void populate(int n, struct set_s *set_p){
+
+	int num,i;
+	char *used = calloc(MAX_RANDOM, sizeof(char));
+
+	for(i=0; i<n; ){
+		num = rand() % MAX_RANDOM;
+		if(used[num])
+			continue;
+		used[num] = 1;
+		i++;
+	}
+
+	set_p->current = malloc(sizeof(struct version_s));
+	set_p->current->snapshot = malloc(sizeof(struct snapshot_s));
+	set_p->current->snapshot->keys = malloc(sizeof(int) * n);
+	set_p->current->snapshot->count = 0;
+	for(num=0; num<MAX_RANDOM; num++){
+		if(used[num])
+			set_p->current->snapshot->keys[set_p->current->snapshot->count++] = num;
+	}
+	set_p->current->delta = NULL;
+	set_p->current->deltaCount = 0;
+	set_p->modifications = 0;
+
+	free(used);
+}
+
+//Calculating time between operation start and end
+double calcTime(clock_t startTime, clock_t endTime) {
+    return (double) (endTime - startTime) / CLOCKS_PER_SEC;
+}
+
+void writeOutput(double mean, double std) {
+	FILE *f = fopen("results.txt", "a");
+	if (f == NULL)
+	{
+		printf("Error occured while opening the file \n");
+		exit(1);
+	}
+
+	fprintf(f,"\n === Snapshot with Delta === \n\n");
+	fprintf(f,"Number of Nodes = %d\n", n);
+	fprintf(f,"Number of Operations = %d\n", m);
+	fprintf(f,"Member Fraction= %.2f\n", mMember);
+	fprintf(f,"Insert Fraction = %.3f\n", mInsert);
+	fprintf(f,"Delete Fraction = %.3f\n", mDelete);
+	fprintf(f,"Number of Threads = %d\n", noOfThreads);
+	fprintf(f,"Max Number of Samples = %d\n", noOfSamples);
+	fprintf(f,"Number of Samples = %d\n", acceptedSamples);
+	fprintf(f,"Rejected Outliers = %d\n", rejectedSamples);
+	fprintf(f,"Min number of samples needed = %f\n", minNoOfSamples);
+	fprintf(f,"Mean = %f\n", mean);
+	fprintf(f,"Standard Deviation = %f\n", std);
+	fprintf(f,"Throughput (ops/sec) = %f\n", mean > 0 ? m / mean : 0.0);
+	fprintf(f,"Confidence Interval (95%%) = +/- %f (%.2f%% of mean)\n", 1.96*std/sqrt(acceptedSamples), mean > 0 ? 100*1.96*std/sqrt(acceptedSamples)/mean : 0.0);
+	fprintf(f,"Merges = %ld\n", merges);
+	if (merges > 0)
+		fprintf(f,"Merge Pause of the Writers (ms) mean = %f, max = %f\n", 1000 * mergePauseTotal / merges, 1000 * mergePauseMax);
+	fprintf(f,"Retired Block Reclaims = %ld\n", reclaims);
+	WRITE_LOCK_PROFILE(f);
+	writeMemoryStats(f);
+	fprintf(f,"________________________________________ \n\n");
+
+	fclose(f);
+}
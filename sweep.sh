@@ -0,0 +1,85 @@
+#!/bin/sh
+# ----------------------------------------------------------------------------
+# Scaling sweep : every threaded variant over a grid of thread counts, mixes and
+# list sizes, timed on the wall clock, then the speedup, efficiency and Amdahl / USL
+# fits of every variant against the serial list (see scaling_fit.c).
+#
+# The grid can be changed from the environment :
+#   THREADS   thread counts (default 1, 2, 4, ... up to 4 x cores, with cores and 2 x cores)
+#   NS        list sizes n (default "1000 10000")
+#   MIXES     member/insert/delete fractions (default "0.99/0.005/0.005 0.90/0.05/0.05 0.500/0.25/0.25")
+#   VARIANTS  threaded programs (default "mutex rw snapshot adaptive hash bitmap")
+#   SAMPLES   maximum samples per configuration (default 20)
+#   M         operations per sample (default 100000)
+#   PLOT=1    also plot the speedups and USL curves to scaling.gp.png with gnuplot
+# ----------------------------------------------------------------------------
+
+CORES=$(nproc 2>/dev/null || echo 1)
+if [ -z "$THREADS" ]; then
+	THREADS=""
+	t=1
+	while [ $t -le $((4 * CORES)) ]; do
+		THREADS="$THREADS $t"
+		t=$((2 * t))
+	done
+	# Every core busy, and twice oversubscribed, even when the core count is not a power of two
+	for t in $CORES $((2 * CORES)); do
+		case " $THREADS " in
+			*" $t "*) ;;
+			*) THREADS="$THREADS $t" ;;
+		esac
+	done
+fi
+NS=${NS:-"1000 10000"}
+MIXES=${MIXES:-"0.99/0.005/0.005 0.90/0.05/0.05 0.500/0.25/0.25"}
+VARIANTS=${VARIANTS:-"mutex rw snapshot adaptive hash bitmap"}
+SAMPLES=${SAMPLES:-20}
+M=${M:-100000}
+
+# ----- Compile the source codes -----------------------------------------
+gcc -g -Wall $CFLAGS -pthread -o serial_linked_list serial_linked_list.c -lm
+for variant in $VARIANTS; do
+	gcc -g -Wall $CFLAGS -pthread -o ${variant}_linked_list ${variant}_linked_list.c -lm
+done
+gcc -g -Wall -o scaling_fit scaling_fit.c -lm
+
+echo "Compilation Finished."
+
+# ----- Revision of the sweep, kept apart from the CPU timed runs of execute.sh -----
+GIT_REVISION=$(git rev-parse --short HEAD 2>/dev/null || echo unknown)
+if [ -n "$(git status --porcelain --untracked-files=no 2>/dev/null)" ]; then
+	GIT_REVISION="$GIT_REVISION-dirty"
+fi
+GIT_REVISION="$GIT_REVISION-sweep"
+export GIT_REVISION
+
+# Speedups need the wall time of a sample, not the CPU time of all its threads
+SAMPLE_CLOCK=wall
+export SAMPLE_CLOCK
+
+echo "...Running Scaling Sweep on $CORES cores, threads :$THREADS..."
+for n in $NS; do
+	for mix in $MIXES; do
+		fractions=$(echo $mix | tr '/' ' ')
+		./serial_linked_list  $SAMPLES $n $M $fractions
+		for variant in $VARIANTS; do
+			for threads in $THREADS; do
+				./${variant}_linked_list  $SAMPLES $n $M $threads $fractions
+			done
+		done
+		echo "n = $n, mix = $mix Finished..."
+	done
+done
+
+# ----- Speedup, efficiency and Amdahl / USL fits of every variant -----------
+if [ "$PLOT" = "1" ]; then
+	./scaling_fit $GIT_REVISION scaling.gp | tee scaling_report.txt
+	if command -v gnuplot >/dev/null 2>&1; then
+		gnuplot scaling.gp && echo "Plot written to scaling.gp.png"
+	else
+		echo "gnuplot not found, run gnuplot scaling.gp to plot"
+	fi
+else
+	./scaling_fit $GIT_REVISION | tee scaling_report.txt
+fi
+echo "Sweep Finished..."
@@ -0,0 +1,272 @@
+/*
+ * Write-ahead log with group commit for the read write lock list
+ *
+ * Every successful Insert/Delete is appended to the calling thread's log buffer while
+ * the list's write lock is still held, tagged with a sequence number which gives the
+ * order of the mutations. A commit thread periodically moves all the buffers to the
+ * log file with one write and one fdatasync. In synchronous mode a thread waits after
+ * releasing the lock until its mutation is durable, in asynchronous mode it does not.
+ * Recovery sorts the records by sequence number and replays them onto an empty list.
+ * A thread whose buffer fills up writes it out itself, ahead of the other buffers, and a
+ * crash can cut a group commit short, so the file need not hold a prefix of the history :
+ * replay stops at the first missing sequence number, as every record after it could
+ * depend on the missing one, and a torn record at the end of the file is ignored. The
+ * records which are not replayed are counted in walDroppedRecords.
+ *
+ * struct list_node_s, Insert() and Delete() have to be declared before this file is included.
+ *
+ * */
+#ifndef WAL_H
+#define WAL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+//Durability modes, given as an optional argument
+#define WAL_OFF 0
+#define WAL_ASYNC 1
+#define WAL_SYNC 2
+
+#define WAL_FILE "linked_list.wal"
+
+//Default period (microseconds) of the group commit
+#define WAL_COMMIT_INTERVAL 1000
+
+//Records buffered per thread before the thread writes them out itself
+#define WAL_BUFFER_RECORDS 4096
+
+#define WAL_INSERT 1
+#define WAL_DELETE 2
+
+//Log record definition
+struct wal_record_s {
+    unsigned long sequence;
+    int op;
+    int key;
+};
+
+//Log buffer of one thread
+struct wal_buffer_s {
+    pthread_mutex_t lock;
+    struct wal_record_s records[WAL_BUFFER_RECORDS];
+    int count;
+    //Records appended, written to the file and made durable so far
+    unsigned long appended;
+    unsigned long written;
+    unsigned long durable;
+} __attribute__((aligned(64)));
+
+static int walMode = WAL_OFF;
+static int walCommitInterval = WAL_COMMIT_INTERVAL;
+
+//One buffer per worker thread and one for the main thread
+static struct wal_buffer_s walBuffers[MAX_THREADS + 1];
+static __thread struct wal_buffer_s *walBuffer = NULL;
+
+//Number of worker threads, the main thread uses the buffer after theirs
+static int walThreads = 0;
+
+static int walFd = -1;
+static unsigned long walSequence = 0;
+static int walStopping = 0;
+static pthread_t walCommitter;
+
+//Serializes writes to the file and signals durability
+static pthread_mutex_t walFileLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t walDurable = PTHREAD_COND_INITIALIZER;
+
+//Commit statistics of the run
+static unsigned long walCommits = 0;
+static unsigned long walRecords = 0;
+
+//Records of the last recovery left out after a gap, and bytes of a torn last record
+static long walDroppedRecords = 0;
+static long walTornBytes = 0;
+
+static inline void walThreadStart(int id) {
+    walBuffer = &walBuffers[id];
+}
+
+//Write a buffer to the file, walFileLock and the buffer's lock must be held
+static inline void walWriteBuffer(struct wal_buffer_s *buffer_p) {
+    size_t length = sizeof(struct wal_record_s) * buffer_p->count;
+    char *data = (char *) buffer_p->records;
+
+    while (length > 0) {
+        ssize_t written = write(walFd, data, length);
+        if (written < 0) {
+            printf("Error occured while writing the log \n");
+            exit(1);
+        }
+        data += written;
+        length -= written;
+    }
+    buffer_p->written += buffer_p->count;
+    buffer_p->count = 0;
+}
+
+//Group commit : write every buffer, then make them durable with one fdatasync
+static inline void walCommit() {
+    unsigned long written[MAX_THREADS + 1];
+    int i, records = 0;
+
+    pthread_mutex_lock(&walFileLock);
+    for (i = 0; i <= walThreads; i++) {
+        pthread_mutex_lock(&walBuffers[i].lock);
+        records += walBuffers[i].count;
+        walWriteBuffer(&walBuffers[i]);
+        written[i] = walBuffers[i].written;
+        pthread_mutex_unlock(&walBuffers[i].lock);
+    }
+
+    if (records > 0) {
+        fdatasync(walFd);
+        walCommits++;
+        walRecords += records;
+    }
+
+    for (i = 0; i <= walThreads; i++)
+        walBuffers[i].durable = written[i];
+    pthread_cond_broadcast(&walDurable);
+    pthread_mutex_unlock(&walFileLock);
+}
+
+static void *walCommitOperation() {
+    while (!__atomic_load_n(&walStopping, __ATOMIC_RELAXED)) {
+        usleep(walCommitInterval);
+        walCommit();
+    }
+    return NULL;
+}
+
+//Start an empty log and its commit thread
+static inline void walOpen(int noOfThreads) {
+    int i;
+
+    if (walMode == WAL_OFF)
+        return;
+
+    walFd = open(WAL_FILE, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (walFd < 0) {
+        printf("Error occured while opening the log \n");
+        exit(1);
+    }
+    walThreads = noOfThreads;
+    for (i = 0; i <= walThreads; i++) {
+        pthread_mutex_init(&walBuffers[i].lock, NULL);
+        walBuffers[i].count = 0;
+        walBuffers[i].appended = 0;
+        walBuffers[i].written = 0;
+        walBuffers[i].durable = 0;
+    }
+    walSequence = 0;
+    walStopping = 0;
+    walThreadStart(walThreads);
+    pthread_create(&walCommitter, NULL, walCommitOperation, NULL);
+}
+
+//Commit what is left and stop the commit thread
+static inline void walClose() {
+    int i;
+
+    if (walMode == WAL_OFF)
+        return;
+
+    __atomic_store_n(&walStopping, 1, __ATOMIC_RELAXED);
+    pthread_join(walCommitter, NULL);
+    walCommit();
+    close(walFd);
+    for (i = 0; i <= walThreads; i++)
+        pthread_mutex_destroy(&walBuffers[i].lock);
+}
+
+//Log a successful mutation, called while the list's write lock is held
+static inline void walAppend(int op, int key) {
+    struct wal_record_s *record_p;
+
+    if (walMode == WAL_OFF)
+        return;
+
+    pthread_mutex_lock(&walBuffer->lock);
+    if (walBuffer->count == WAL_BUFFER_RECORDS) {
+        //Full buffer, write it out without waiting for the commit thread
+        pthread_mutex_unlock(&walBuffer->lock);
+        pthread_mutex_lock(&walFileLock);
+        pthread_mutex_lock(&walBuffer->lock);
+        walWriteBuffer(walBuffer);
+        pthread_mutex_unlock(&walFileLock);
+    }
+    record_p = &walBuffer->records[walBuffer->count++];
+    record_p->sequence = walSequence++;
+    record_p->op = op;
+    record_p->key = key;
+    walBuffer->appended++;
+    pthread_mutex_unlock(&walBuffer->lock);
+}
+
+//In synchronous mode, wait until the thread's mutations are durable
+static inline void walWait() {
+    unsigned long target;
+
+    if (walMode != WAL_SYNC)
+        return;
+
+    target = walBuffer->appended;
+    pthread_mutex_lock(&walFileLock);
+    while (walBuffer->durable < target)
+        pthread_cond_wait(&walDurable, &walFileLock);
+    pthread_mutex_unlock(&walFileLock);
+}
+
+static int walCompareRecords(const void *a, const void *b) {
+    unsigned long x = ((const struct wal_record_s *) a)->sequence;
+    unsigned long y = ((const struct wal_record_s *) b)->sequence;
+    return (x > y) - (x < y);
+}
+
+//Replay the longest gap free prefix of the log onto an empty list
+//Returns the number of records replayed, the others are counted in walDroppedRecords
+static inline long walRecover(struct list_node_s **head_pp) {
+    struct wal_record_s *records;
+    long size, count, i;
+    unsigned long expected = 0;
+    FILE *f = fopen(WAL_FILE, "rb");
+
+    if (f == NULL) {
+        printf("Error occured while opening the log \n");
+        exit(1);
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    count = size / sizeof(struct wal_record_s);
+    fseek(f, 0, SEEK_SET);
+
+    //A partly written last record is not read
+    walTornBytes = size - count * sizeof(struct wal_record_s);
+
+    records = malloc(sizeof(struct wal_record_s) * (count > 0 ? count : 1));
+    count = fread(records, sizeof(struct wal_record_s), count, f);
+    fclose(f);
+
+    qsort(records, count, sizeof(struct wal_record_s), walCompareRecords);
+    for (i = 0; i < count; i++) {
+        if (records[i].sequence != expected ||
+            (records[i].op != WAL_INSERT && records[i].op != WAL_DELETE))
+            break;
+        if (records[i].op == WAL_INSERT)
+            Insert(records[i].key, head_pp);
+        else
+            Delete(records[i].key, head_pp);
+        expected++;
+    }
+    walDroppedRecords = count - i;
+
+    free(records);
+    return i;
+}
+
+#endif